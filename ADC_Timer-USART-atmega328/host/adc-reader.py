@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+Read the sample blocks sent by ADC_Timer-USART-atmega328.
+
+Checks the checksum and the block numbers (a gap is a block the
+AVR dropped), prints the statistics every second and optionally
+saves the samples, one per line.
+
+    ./adc-reader.py /dev/tty.usbserial-A600 [-b 250000] [-o samples.txt]
+
+Needs pyserial (pip install pyserial).
+"""
+
+import argparse
+import sys
+import time
+
+import serial
+
+SYNC = b'\xA5\x5A'
+SAMPLES = 64  # ADC_CAPTURE_SIZE
+BLOCK = 2 + SAMPLES * 5 // 4 + 1  # seq, samples, checksum
+
+
+def unpack(data):
+    """4 samples in 5 bytes: 4 low bytes, then the high 2 bits of each"""
+    samples = []
+    for i in range(0, len(data), 5):
+        high = data[i + 4]
+        for j in range(4):
+            samples.append(data[i + j] | ((high >> (2 * j)) & 3) << 8)
+    return samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('port')
+    parser.add_argument('-b', '--baud', type=int, default=250000)
+    parser.add_argument('-o', '--output', help='file for the samples')
+    args = parser.parse_args()
+
+    port = serial.Serial(args.port, args.baud, timeout=1)
+    out = open(args.output, 'w') if args.output else None
+
+    blocks = dropped = bad = 0
+    last = None
+    start = shown = time.time()
+    buf = b''
+    while True:
+        try:
+            buf += port.read(port.in_waiting or 1)
+        except KeyboardInterrupt:
+            break
+
+        while True:
+            i = buf.find(SYNC)
+            if i < 0:
+                buf = buf[-1:]
+                break
+            if len(buf) < i + 2 + BLOCK:
+                buf = buf[i:]
+                break
+            frame = buf[i + 2:i + 2 + BLOCK]
+            if sum(frame[:-1]) & 0xFF != frame[-1]:
+                bad += 1                 # not a block, or damaged: resync
+                buf = buf[i + 1:]
+                continue
+            buf = buf[i + 2 + BLOCK:]
+
+            seq = frame[0] | frame[1] << 8
+            if last is not None:
+                dropped += (seq - last - 1) & 0xFFFF
+            last = seq
+            blocks += 1
+            if out:
+                out.writelines('%d\n' % s for s in unpack(frame[2:-1]))
+
+        now = time.time()
+        if now - shown >= 1:
+            shown = now
+            rate = blocks * SAMPLES / (now - start)
+            sys.stderr.write('\rblocks %d  dropped %d  bad %d  %.0f samples/s  '
+                             % (blocks, dropped, bad, rate))
+
+    sys.stderr.write('\n')
+    if out:
+        out.close()
+
+
+if __name__ == '__main__':
+    main()
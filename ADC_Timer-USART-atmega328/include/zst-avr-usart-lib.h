@@ -0,0 +1,62 @@
+#ifndef __ZST_USART_LIB__
+#define __ZST_USART__LIB__
+
+#include <util/setbaud.h>
+#include <avr/pgmspace.h>
+#include <stdio.h>
+
+void uart_putchar(char c, FILE *stream);
+char uart_getchar(FILE *stream);
+void uart_init(void);
+void uart_puts_P(const char *s);
+void uart_write(uint8_t b);
+
+/* http://www.ermicro.com/blog/?p=325 */
+FILE uart_output = FDEV_SETUP_STREAM(uart_putchar, NULL, _FDEV_SETUP_WRITE);
+FILE uart_input = FDEV_SETUP_STREAM(NULL, uart_getchar, _FDEV_SETUP_READ);
+
+#define uart_redirect() { stdout = &uart_output; stdin = &uart_input; }
+
+/* http://www.cs.mun.ca/~rod/Winter2007/4723/notes/serial/serial.html */
+void uart_init(void) {
+    UBRR0H = UBRRH_VALUE;
+    UBRR0L = UBRRL_VALUE;
+    
+#if USE_2X
+    UCSR0A |= _BV(U2X0);
+#else
+    UCSR0A &= ~(_BV(U2X0));
+#endif
+
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00); /* 8-bit data */ 
+    //UCSR0C = (3<<UCSZ00); /* Frame format: 8data, No parity, 1 stop bit */
+    UCSR0B = _BV(RXEN0) | _BV(TXEN0);   /* Enable RX and TX */
+}
+
+void uart_putchar(char c, FILE *stream) {
+    if (c == '\n') {
+        uart_putchar('\r', stream);
+    }
+    loop_until_bit_is_set(UCSR0A, UDRE0);
+    UDR0 = c;
+}
+
+/* Send a string stored in flash (PSTR), without going through stdout */
+void uart_puts_P(const char *s) {
+    char c;
+    while ((c = pgm_read_byte(s++)))
+        uart_putchar(c, NULL);
+}
+
+/* Send a byte as it is (binary data, no \n -> \r\n) */
+void uart_write(uint8_t b) {
+    loop_until_bit_is_set(UCSR0A, UDRE0);
+    UDR0 = b;
+}
+
+char uart_getchar(FILE *stream) {
+    loop_until_bit_is_set(UCSR0A, RXC0);
+    return UDR0;
+}
+
+#endif
@@ -0,0 +1,97 @@
+/* 
+ * ATmega328
+ *
+ * Sample ADC0 (PC0) at an exact rate and stream
+ * the samples over the USART.
+ *
+ * Timer1 starts every conversion (auto trigger on
+ * compare match B), so there is no jitter from the
+ * code. The ADC interrupt fills two buffers of 64
+ * samples in turn (ping-pong); the main loop sends
+ * each full buffer while the other one fills.
+ *
+ * Block format (85 bytes for 64 samples):
+ *   0xA5 0x5A                sync
+ *   seq (2 bytes, LSB first) block number, +1 per block
+ *   samples, 4 in 5 bytes:   low 8 bits of s0, s1, s2, s3, then
+ *                            bits 9-8 of s0 | s1 << 2 | s2 << 4 | s3 << 6
+ *   checksum                 sum of the seq and sample bytes (8 bit)
+ *
+ * A dropped block (main loop too slow) leaves a gap
+ * in the block numbers. host/adc-reader.py checks
+ * the numbers and checksums and saves the samples.
+ *
+ * Highest sample rate without drops, 64 samples per
+ * block: 10 bits per UART byte, 12.5 bits per sample
+ * + 5 bytes per block = 13.3 bits per sample.
+ *   BAUD    samples/s
+ *   9600    720
+ *   38400   2890
+ *   57600   4330
+ *   76800   5780
+ *   250000  9250 (ADC limit: 125kHz / 13.5)
+ * Calculated, not measured. 115200 is 3.5% off at
+ * 8MHz, use 76800 or 250000 instead.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "zst-adc.h"
+#include "zst-avr-usart-lib.h"
+
+#define SAMPLE_RATE 5000 // Hz, F_CPU / 8 / SAMPLE_RATE should be a whole number
+#define SAMPLE_CHANNEL 0 // ADC0 (PC0)
+
+#if ADC_CAPTURE_SIZE % 4
+    #error "ADC_CAPTURE_SIZE must be a multiple of 4 (4 samples in 5 bytes)"
+#endif
+#if SAMPLE_RATE > ADC_CAPTURE_MAX_HZ || F_CPU / 8 / SAMPLE_RATE > 65536
+    #error "SAMPLE_RATE out of range for ADC_CaptureStart"
+#endif
+
+static uint8_t sum;
+
+static void send(uint8_t b) {
+    sum += b;
+    uart_write(b);
+}
+
+/* Send a block: sync, number, packed 10 bit samples, checksum */
+static void send_block(const uint16_t *block, uint16_t seq) {
+    uint16_t i;
+    uint8_t j, high;
+
+    uart_write(0xA5);
+    uart_write(0x5A);
+    sum = 0;
+    send(seq & 0xFF);
+    send(seq >> 8);
+    for (i = 0; i < ADC_CAPTURE_SIZE; i += 4) {
+        high = 0;
+        for (j = 0; j < 4; j++) {
+            send(block[i + j] & 0xFF);
+            high |= (block[i + j] >> 8) << (2 * j);
+        }
+        send(high);
+    }
+    uart_write(sum);
+}
+
+int main(void) {
+    uart_init(); // Setup UART with <util/setbaud.h> for baud rate calculation
+
+    ADC_CaptureStart(SAMPLE_CHANNEL, SAMPLE_RATE);
+    sei();
+
+    const uint16_t *block;
+    uint16_t seq;
+    while(1) {
+        block = ADC_CaptureBlock(&seq);
+        if (block) {
+            send_block(block, seq);
+            ADC_CaptureRelease(block); // free for the interrupt again
+        }
+    }
+
+    return 0;
+}
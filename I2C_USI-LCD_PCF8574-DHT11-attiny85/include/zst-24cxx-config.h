@@ -0,0 +1,10 @@
+#ifndef __ZST_24CXX_CONFIG__
+#define __ZST_24CXX_CONFIG__
+
+// 24C32 on the LCD's I2C bus, A2..A0 = 0 (see zst-24cxx.h)
+#define EE24_ADDRESS    0x50
+#define EE24_SIZE       4096
+#define EE24_PAGE_SIZE  32
+#define EE24_LOG_START  256     // first 256 bytes for the benchmark
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __ZST_LCD_HD44780_CONFIG__
+#define __ZST_LCD_HD44780_CONFIG__
+
+// LCD connected through a PCF8574 I2C backpack (see zst-hd44780.h)
+#define LCD_BACKEND LCD_BACKEND_PCF8574
+
+#endif
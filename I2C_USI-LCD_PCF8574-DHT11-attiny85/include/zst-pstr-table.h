@@ -0,0 +1,12 @@
+// Strings kept in flash (see zst-pstr.h)
+// No include guard: included once for declarations and once for definitions
+PSTR_ENTRY(STR_HELLO,       "Hello world!!!")
+PSTR_ENTRY(STR_I2C_DEVICES, "I2C devices: ")
+PSTR_ENTRY(STR_I2C_MERGED,  "I2C merged: ")
+PSTR_ENTRY(STR_LOG,         "Log: ")
+PSTR_ENTRY(STR_BENCH_W,     "W B/s ")
+PSTR_ENTRY(STR_BENCH_R,     "R B/s ")
+PSTR_ENTRY(STR_DHT_FAILED,  "Read DHT11 failed.")
+PSTR_ENTRY(STR_DEG_C,       "deg C")
+PSTR_ENTRY(STR_RH,          "RH: ")
+PSTR_ENTRY(STR_PERCENT,     "% ")
@@ -8,14 +8,50 @@
  * Interface with an I2C LCD display to display
  * the readings of the DHT11. The HD44780 LCD 
  * display with PCF8574 backpack is used.
+ * The temperature is shown with big digits made
+ * of custom CGRAM characters.
  * 
  * The USI module of the tinyAVR is used for I2C.
  * An Arduino library (TinyWireM) is modified to
  * work with pure AVR code.
  *
- * The LCD library is modified to "push" changes
- * of the LCD port register using "LCD_I2C_Push"
- * every time there is a strobe.
+ * The LCD library sends the PCF8574 register
+ * values for each LCD byte using "LCD_I2C_Write"
+ * (one I2C transaction per byte). The writes go
+ * through the I2C scheduler (zst-i2c-sched.h) as
+ * high priority jobs, so the bus can be shared
+ * with other I2C devices. The bus is scanned at
+ * startup and the LCD is found at any PCF8574 or
+ * PCF8574A address. At startup two backlight writes
+ * are queued before the queue is run, to show that
+ * they are merged into one transaction (shown as
+ * jobs/transactions).
+ *
+ * The DHT11 is read in the background every
+ * second (SimpleDHT11::begin). The main loop only
+ * updates the LCD when a new reading is done and
+ * keeps showing the last good one for a few
+ * failed readings. The values shown are the
+ * median of the last 3 good readings (zst-dsp.h),
+ * so a single wrong reading is not shown.
+ *
+ * One reading a minute (LOG_EVERY) is appended
+ * to a log in a 24C32 I2C EEPROM (zst-24cxx.h),
+ * so the EEPROM lasts ~230 years instead of ~4
+ * at one record a second (see the wear note in
+ * zst-24cxx.h). The EEPROM goes through the I2C
+ * scheduler too. The number of logged readings
+ * is shown at startup. Set
+ * EEPROM_BENCHMARK to 1 to measure page writes
+ * and sequential reads against per byte access
+ * at startup (uses Timer1 before the DHT11 does,
+ * and the first 256 bytes of the EEPROM).
+ *
+ * Expected at 100KHz, computed from the bus time
+ * (9 bits per byte) and the 5ms write cycle, not
+ * measured: per byte write ~180 B/s, page write
+ * ~3900 B/s, per byte read ~2000 B/s, sequential
+ * read ~9700 B/s (32 byte blocks).
  *
  * Connections:
  *     PB4 - DHT11 data pin
@@ -24,28 +60,184 @@
  */
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include <util/delay.h>
+#include <util/atomic.h>
 #include <SimpleDHT.h>
-#include "zst-i2c-lcd-lib.h"
+#include "zst-dsp.h"
+#include "zst-hd44780.h"
+#include "zst-lcd-cgram.h"
+#include "zst-pstr.h"
 #include "TinyWireM.h"
+#include "zst-i2c-sched.h"
+#include "zst-24cxx.h"
+
+#define EEPROM_BENCHMARK 0
 
-#define LCD_I2C_ADDRESS (0x78 >> 1)
+#define READING_MAX_AGE_MS 5000     // show the last good reading this long after errors
+#define LOG_EVERY 60                // readings (seconds) per log record, for the EEPROM wear
+
+#define LCD_I2C_ADDRESS (0x78 >> 1)     // used if the scan finds no PCF8574
+#define PCF8574_BACKLIGHT _BV(3)        // P3, see zst-hd44780-pcf8574.h
+
+static uint8_t lcd_address = LCD_I2C_ADDRESS;
 
 // http://playground.arduino.cc/Code/USIi2c
-void LCD_I2C_Push(uint8_t push) {
-    TinyWireM.beginTransmission(LCD_I2C_ADDRESS);
-    TinyWireM.send(push);
-    TinyWireM.endTransmission();
+void LCD_I2C_Write(const uint8_t *data, uint8_t len) {
+    USI_TWI_Segment seg[] = { USI_TWI_SEG_TX(data, len) };  // sent in place, no copy
+    I2C_Job job = { lcd_address, I2C_JOB_HIGH | I2C_JOB_MERGE, 1, seg, 0, NULL };
+    I2C_Run(&job);
 }
 
+// First PCF8574 (0x20-0x27) or PCF8574A (0x38-0x3F) on the bus
+static uint8_t find_lcd(const uint8_t *found, uint8_t count) {
+    uint8_t i;
+    for (i = 0; i < count; i++) {
+        if ((found[i] & 0xF8) == 0x20 || (found[i] & 0xF8) == 0x38)
+            return found[i];
+    }
+    return LCD_I2C_ADDRESS;
+}
+
+// Transactions sent to the LCD so far (scheduler statistics)
+static uint16_t lcd_transactions(void) {
+    uint8_t i, count;
+    const I2C_DeviceStats *stats = I2C_Stats(&count);
+    for (i = 0; i < count; i++)
+        if (stats[i].address == lcd_address)
+            return stats[i].transactions;
+    return 0;
+}
+
+// Queues two writes to the PCF8574 (backlight off, then on again, En
+// low so the LCD ignores them) and runs the queue once. Both are merge
+// writes to the same address, so they go out as one 2 byte transaction.
+static void i2c_merge_demo(void) {
+    static const uint8_t off = 0, on = PCF8574_BACKLIGHT;
+    USI_TWI_Segment seg_off[] = { USI_TWI_SEG_TX(&off, 1) };
+    USI_TWI_Segment seg_on[] = { USI_TWI_SEG_TX(&on, 1) };
+    I2C_Job job_off = { lcd_address, I2C_JOB_MERGE, 1, seg_off, 0, NULL };
+    I2C_Job job_on = { lcd_address, I2C_JOB_MERGE, 1, seg_on, 0, NULL };
+    uint16_t transactions = lcd_transactions();
+    uint8_t jobs;
+
+    I2C_Submit(&job_off);
+    I2C_Submit(&job_on);
+    jobs = I2C_Poll();
+    transactions = lcd_transactions() - transactions;
+
+    LCD_Clear();
+    LCD_Message_P(STR_I2C_MERGED);
+    LCD_Integer(jobs);
+    LCD_Char('/');
+    LCD_Integer(transactions);
+    _delay_ms(1000);
+}
+
+#if EEPROM_BENCHMARK
+static volatile uint16_t ms;
+
+ISR(TIMER1_COMPA_vect) {
+    ms++;
+}
+
+static uint16_t millis(void) {
+    uint16_t t;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        t = ms;
+    }
+    return t;
+}
+
+// Bytes per second for 256 bytes that took the time since start
+static uint16_t rate(uint16_t start) {
+    uint16_t t = millis() - start;
+    return t ? 256000UL / t : 0;
+}
+
+static void eeprom_benchmark(void) {
+    uint8_t buf[32];
+    uint16_t i, start, w1, w32, r1, r32;
+
+    /* Timer1: CTC, F_CPU/64, 1ms */
+    OCR1C = F_CPU / 64 / 1000 - 1;
+    OCR1A = OCR1C;
+    TCCR1 = (1 << CTC1) | (1 << CS12) | (1 << CS11) | (1 << CS10);
+    TIMSK |= (1 << OCIE1A);
+    sei();
+
+    for (i = 0; i < sizeof(buf); i++)
+        buf[i] = i;
+
+    start = millis();
+    for (i = 0; i < 256; i++)
+        EE24_Write(i, &buf[i % sizeof(buf)], 1);   // waits for each write cycle
+    EE24_Wait();
+    w1 = rate(start);
+
+    start = millis();
+    for (i = 0; i < 256; i += sizeof(buf))
+        EE24_Write(i, buf, sizeof(buf));            // one page per transaction
+    EE24_Wait();
+    w32 = rate(start);
+
+    start = millis();
+    for (i = 0; i < 256; i++)
+        EE24_Read(i, buf, 1);                       // address + read per byte
+    r1 = rate(start);
+
+    start = millis();
+    for (i = 0; i < 256; i += sizeof(buf))
+        EE24_Read(i, buf, sizeof(buf));             // sequential read
+    r32 = rate(start);
+
+    TIMSK &= ~(1 << OCIE1A);    // Timer1 is the DHT11's from here
+    TCCR1 = 0;
+
+    LCD_Clear();
+    LCD_Message_P(STR_BENCH_W);
+    LCD_Integer(w1);
+    LCD_Char(' ');
+    LCD_Integer(w32);
+    LCD_MoveCursor(0,1);
+    LCD_Message_P(STR_BENCH_R);
+    LCD_Integer(r1);
+    LCD_Char(' ');
+    LCD_Integer(r32);
+    _delay_ms(5000);
+}
+#endif
+
 int main(void) {
     /* Setup I2C with USI */
     TinyWireM.begin();
 
+    /* Find the devices on the bus */
+    uint8_t found[8];
+    uint8_t devices = I2C_Scan(found, sizeof(found));
+    lcd_address = find_lcd(found, devices < sizeof(found) ? devices : sizeof(found));
+
     /* Setup LCD */
     LCD_Init();
     LCD_MoveCursor(0,0);
-    LCD_Message("Hello world!!!");
+    LCD_Message_P(STR_HELLO);
+    LCD_MoveCursor(0,1);
+    LCD_Message_P(STR_I2C_DEVICES);
+    LCD_Integer(devices);
+    _delay_ms(1000);
+
+    /* Two queued writes, one transaction */
+    i2c_merge_demo();
+
+    /* Find the end of the log in the EEPROM */
+#if EEPROM_BENCHMARK
+    eeprom_benchmark();
+#endif
+    EE24_LogOpen();
+    LCD_Clear();
+    LCD_Message_P(STR_LOG);
+    LCD_Integer(EE24_LogCount());
+    _delay_ms(1000);
 
     /* Setup DHT11 library */
     SimpleDHT11 dht11;
@@ -53,27 +245,74 @@ int main(void) {
             .ddr = &DDRB, .pin = &PINB, .port = &PORTB, .pos = PB4
     };
 
+    // Read every second in the background (Timer1 and pin change
+    // interrupts)
+    sei();
+    dht11.begin(pin_type);
+    uint16_t attempts = 0;
+    uint8_t log_wait = 0;
+
+    // Median of the last 3 good readings
+    static int16_t temperature_buf[2 * 3], humidity_buf[2 * 3];
+    DSP_Median temperature_median, humidity_median;
+    uint8_t temperature = 0, humidity = 0;
+    bool first = true;
+
     LCD_Clear();
 
     while (1) {
-        uint8_t temperature = 0, humidity = 0, err = 0;
-        err = dht11.read(pin_type, &temperature, &humidity, NULL);
-        if (err) {
+        DHTReading r;
+        bool valid = dht11.latest(&r);
+
+        // Nothing to do until the next reading is done, the loop is
+        // free for other work.
+        if (r.attempts == attempts)
+            continue;
+        attempts = r.attempts;
+
+        if (!log_wait--) {
+            uint8_t record[EE24_LOG_DATA] = { r.temperature, r.humidity, r.error };
+            EE24_LogAppend(record);
+            log_wait = LOG_EVERY - 1;
+        }
+        if (!valid || r.age > READING_MAX_AGE_MS) {
             LCD_MoveCursor(0,0);
-            LCD_Message("Read DHT11 failed.");
+            LCD_Message_P(STR_DHT_FAILED);
 
             LCD_MoveCursor(0,1);
-            LCD_Integer(err);
+            LCD_Integer(r.error);
         } else {
-            LCD_MoveCursor(0,0);
-            LCD_Message("Humidity: ");
-            LCD_Integer((int) humidity);
+            if (first) { // start with the first reading, not 0
+                DSP_MedianInit(&temperature_median, temperature_buf, 3, r.temperature);
+                DSP_MedianInit(&humidity_median, humidity_buf, 3, r.humidity);
+                temperature = r.temperature;
+                humidity = r.humidity;
+                first = false;
+            }
+            if (!r.error) { // a new reading, not the last good one again
+                temperature = DSP_MedianPut(&temperature_median, r.temperature);
+                humidity = DSP_MedianPut(&humidity_median, r.humidity);
+            }
 
-            LCD_MoveCursor(0,1);
-            LCD_Message("Temperature: ");
-            LCD_Integer((int) temperature);
+            // Big digits only upload glyphs that are not yet in CGRAM.
+            // Always 2 digits (DHT11 range is 0-50). They are 3 columns wide,
+            // so clear the gaps after them (columns 3 and 7), which the error
+            // text may have written to.
+            for (uint8_t row = 0; row < 2; row++) {
+                LCD_MoveCursor(3, row);
+                LCD_Char(' ');
+                LCD_MoveCursor(7, row);
+                LCD_Char(' ');
+            }
+            LCD_BigDigit(0, 0, temperature / 10);
+            LCD_BigDigit(4, 0, temperature % 10);
+            LCD_MoveCursor(8,0);
+            LCD_Message_P(STR_DEG_C);
+
+            LCD_MoveCursor(8,1);
+            LCD_Message_P(STR_RH);
+            LCD_Integer((int) humidity);
+            LCD_Message_P(STR_PERCENT);
         }
-        // DHT11 sampling rate is 1 Hz.
-        _delay_ms(1000);
     }
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+ * ATtiny85
+ *
+ * DHT11 sensor node on an I2C bus. The ATtiny85
+ * is an I2C slave (zst-usi-slave.h) and a bus
+ * master (e.g. an ATmega328 with its TWI module)
+ * polls the readings from many such nodes.
+ *
+ * Register map (read only, pointer wraps at 8):
+ *     0 - status: bit 0 data valid, bit 1 last read failed
+ *     1 - temperature (deg C)
+ *     2 - humidity (%)
+ *     3 - last DHT11 error code
+ *     4 - readings, low byte  (16 bit counter)
+ *     5 - readings, high byte
+ *     6 - failed readings, low byte
+ *     7 - failed readings, high byte
+ *
+ * The DHT11 is read in the background every
+ * second (SimpleDHT11::begin). The CPU sleeps
+ * (idle) between the interrupts.
+ *
+ * Master: write the register number, repeated
+ * START, read up to 8 bytes. All bytes of one
+ * read are from the same DHT11 reading.
+ *
+ * Connections:
+ *     PB4 - DHT11 data pin
+ *     PB2 - I2C SCL
+ *     PB0 - I2C SDA
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <SimpleDHT.h>
+#include "zst-usi-slave.h"
+
+#define SLAVE_ADDRESS   0x30    // one per node
+
+#define REG_STATUS      0
+#define REG_TEMPERATURE 1
+#define REG_HUMIDITY    2
+#define REG_ERROR       3
+#define REG_READINGS    4
+#define REG_FAILED      6
+
+#define STATUS_VALID    0x01
+#define STATUS_FAILED   0x02
+
+int main(void) {
+    uint16_t attempts = 0, failed = 0;
+
+    /* Setup I2C slave with USI */
+    USI_Slave_Init(SLAVE_ADDRESS);
+    sei();
+
+    /* Setup DHT11 library */
+    SimpleDHT11 dht11;
+    const pinType pin_type = {
+            .ddr = &DDRB, .pin = &PINB, .port = &PORTB, .pos = PB4
+    };
+
+    // Read every second in the background (Timer1 interrupts)
+    dht11.begin(pin_type);
+    set_sleep_mode(SLEEP_MODE_IDLE);
+
+    while (1) {
+        DHTReading r;
+        dht11.latest(&r);
+        if (r.attempts == attempts) {
+            sleep_mode();               // until the next interrupt
+            continue;
+        }
+        attempts = r.attempts;
+
+        // Fill the spare register buffer, then publish it at once
+        uint8_t *regs = USI_Slave_Begin_Update();
+        if (r.error) {
+            failed++;
+            regs[REG_STATUS] |= STATUS_FAILED;
+            regs[REG_ERROR] = r.error;
+        } else {
+            regs[REG_STATUS] = STATUS_VALID;
+            regs[REG_TEMPERATURE] = r.temperature;
+            regs[REG_HUMIDITY] = r.humidity;
+        }
+        regs[REG_READINGS] = attempts;
+        regs[REG_READINGS + 1] = attempts >> 8;
+        regs[REG_FAILED] = failed;
+        regs[REG_FAILED + 1] = failed >> 8;
+        USI_Slave_Commit();
+    }
+}
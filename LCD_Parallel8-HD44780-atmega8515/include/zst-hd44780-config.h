@@ -0,0 +1,23 @@
+#ifndef __ZST_LCD_HD44780_CONFIG__
+#define __ZST_LCD_HD44780_CONFIG__
+
+// LCD connected with 8 data lines (see zst-hd44780.h)
+// Change to LCD_BACKEND_PARALLEL4 to compare with 4-bit mode,
+// it only uses DB4-DB7 so the wiring stays the same.
+#define LCD_BACKEND LCD_BACKEND_PARALLEL8
+
+// Data lines: DB0-DB7 on PA0-PA7
+#define LCD_DATA_PORT PORTA
+#define LCD_DATA_DDR DDRA
+// Used in 4-bit mode only
+#define LCD_D4 PA4
+#define LCD_D5 PA5
+#define LCD_D6 PA6
+#define LCD_D7 PA7
+// Control lines must be on the same port
+#define LCD_CONTROL_PORT PORTC
+#define LCD_CONTROL_DDR DDRC
+#define LCD_RS PC0
+#define LCD_E PC1
+
+#endif
@@ -0,0 +1,91 @@
+/* 
+ * ATmega8515
+ *
+ * Interface with a HD44780 LCD display in
+ * 8-bit mode. A whole character is written
+ * with one port write and one enable pulse.
+ *
+ * The speed of the LCD library is measured
+ * with Timer1 and displayed in characters per
+ * second. Set LCD_BACKEND to 4-bit mode in
+ * zst-hd44780-config.h to compare both modes.
+ *
+ * Expected at 8MHz: the controller needs 37us
+ * to execute every byte, which is the same in
+ * both modes. 8-bit mode saves 1 port write and
+ * 1 enable pulse per char (~2us of ~42us), so
+ * it is only a few % faster in chars per second
+ * but spends half the time toggling pins.
+ */
+
+#include <avr/io.h>
+#include <util/delay.h>
+#include <stdlib.h>
+#include "zst-hd44780.h"
+
+/* 
+ * ----------------------------------
+ * PIN CONNECTIONS FOR LCD
+ * (01) Vss - GND
+ * (02) Vdd - 5V
+ * (03) Vee - Pot Contrast
+ * (04) RS  - PC0
+ * (05) R/W - GND
+ * (06) En  - PC1
+ * (07) DB0 - PA0
+ * (08) DB1 - PA1
+ * (09) DB2 - PA2
+ * (10) DB3 - PA3
+ * (11) DB4 - PA4
+ * (12) DB5 - PA5
+ * (13) DB6 - PA6
+ * (14) DB7 - PA7
+ * (15) LED (+) - 5V
+ * (16) LED (-) - GND
+ * ----------------------------------
+ */
+
+#define BENCH_CHARS 256 // 16 rows of 16 chars
+#define TIMER1_PRESCALER 64 // 8us per tick at 8MHz, overflows after 524ms
+
+int main(void) {
+    /* Setup LCD */
+    LCD_Init();
+    LCD_MoveCursor(0, 0);
+#if LCD_BACKEND == LCD_BACKEND_PARALLEL8
+    LCD_Message_P(PSTR("8-bit mode"));
+#else
+    LCD_Message_P(PSTR("4-bit mode"));
+#endif
+    _delay_ms(2000); // wait
+
+    /* Setup Timer1: normal mode, counting at F_CPU/64 */
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11) | _BV(CS10);
+
+    while (1) {
+        uint16_t start, ticks;
+        uint8_t i, j;
+
+        /* Fill line 0 over and over */
+        start = TCNT1;
+        for (i = 0; i < BENCH_CHARS / 16; i++) {
+            LCD_MoveCursor(0, 0);
+            for (j = 0; j < 16; j++) {
+                LCD_Char('A' + i);
+            }
+        }
+        ticks = TCNT1 - start; // unsigned subtraction handles a wrap of TCNT1
+
+        /* chars per second = chars / (ticks * prescaler / F_CPU) */
+        LCD_MoveCursor(0, 1);
+        LCD_Message_P(PSTR("c/s: "));
+        char st[12] = "";
+        ultoa((uint32_t) BENCH_CHARS * (F_CPU / TIMER1_PRESCALER) / ticks, st, 10);
+        LCD_Message(st);
+        LCD_Message_P(PSTR("   "));
+
+        _delay_ms(1000);
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+#ifndef __ZST_ADC_CONTROL_CONFIG__
+#define __ZST_ADC_CONTROL_CONFIG__
+
+#include "zst-timer1-pwm.h"
+
+// Green LED brightness held by a PI loop: OC1A drives it, ADC7 measures
+// it (light sensor next to the LED, or the voltage on a current sense
+// resistor, through an RC filter longer than the PWM period).
+// The output spans 0 to PWM1_TOP (399 at 20kHz), the input 0 to 1023,
+// so a gain of 100 is 1:1 (full scale to full scale).
+#define ADC_CTRL_KP 64                  // 0.64
+#define ADC_CTRL_KI 4                   // 0.04 per loop run
+#define ADC_CTRL_KD 0
+
+// Written straight to OCR1A, never set with PWM1_Set (see zst-timer1-pwm.h)
+#define ADC_CTRL_OUT_MAX PWM1_TOP
+#define ADC_CTRL_OUTPUT(v) (OCR1A = (v))
+
+// Conversions started by the Timer0 overflow. TOV0 is cleared by the
+// fade interrupt (TIM0_OVF_vect). Unprescaled, Timer0 overflows every
+// 256 cycles, faster than a conversion (13.5 ADC clocks plus up to
+// one ADC clock and 3 cycles to synchronize: 931 cycles at 8MHz / 64).
+// The ADC ignores the triggers while it converts, so the hardware
+// divides: every 4th overflow starts one, 7812 times/s at 8MHz, still
+// exactly on an overflow.
+#define ADC_CTRL_CONV_CYCLES (27UL * ADC_PRESCALE / 2 + ADC_PRESCALE + 3)
+#define ADC_CTRL_TRIG_DIV (ADC_CTRL_CONV_CYCLES / 256 + 1)
+#define ADC_CTRL_TRIGGER ADC_TRIG_TIMER0_OVF
+#define ADC_CTRL_ACK()
+#define ADC_CTRL_HZ (F_CPU / 256 / ADC_CTRL_TRIG_DIV)
+
+// TCNT0 wraps on every overflow, so the delays are counted from the
+// last overflow before the end of the conversion (ADC_CTRL_TIMER_BASE
+// cycles after the trigger): right up to the next trigger, ~90 cycles
+// after the conversion. Later interrupts, e.g. behind a fade step
+// (250/s), are counted as invalid (the LCD shows a '!'). TOV0 stays
+// set while the ADC interrupt runs, so interrupts up to 511 cycles
+// are timed (the tiny84 PI ~250-400).
+#define ADC_CTRL_TIMER TCNT0
+#define ADC_CTRL_TIMER_DIV 1
+#define ADC_CTRL_TIMER_BASE ((ADC_CTRL_TRIG_DIV - 1) * 256UL)
+#define ADC_CTRL_TIMER_OVF() (TIFR0 & _BV(TOV0))
+
+#endif
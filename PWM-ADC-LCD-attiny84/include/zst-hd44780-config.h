@@ -0,0 +1,20 @@
+#ifndef __ZST_LCD_HD44780_CONFIG__
+#define __ZST_LCD_HD44780_CONFIG__
+
+// LCD connected with 4 data lines (see zst-hd44780.h)
+#define LCD_BACKEND LCD_BACKEND_PARALLEL4
+
+// Data lines must be on the same port
+#define LCD_DATA_PORT PORTA
+#define LCD_DATA_DDR DDRA
+#define LCD_D4 PA0
+#define LCD_D5 PA1
+#define LCD_D6 PA2
+#define LCD_D7 PA3
+// Control lines must be on the same port
+#define LCD_CONTROL_PORT PORTB
+#define LCD_CONTROL_DDR DDRB
+#define LCD_RS PB0
+#define LCD_E PB1
+
+#endif
@@ -0,0 +1,15 @@
+// Strings kept in flash (see zst-pstr.h)
+// No include guard: included once for declarations and once for definitions
+PSTR_ENTRY(STR_HELLO,      "Hello World.")
+PSTR_ENTRY(STR_ADC,        "ADC: ")
+PSTR_ENTRY(STR_RGB,        "RGB ")
+PSTR_ENTRY(STR_PWM1,       "T1 ")
+PSTR_ENTRY(STR_HZ,         "Hz ")
+PSTR_ENTRY(STR_BITS,       " bit")
+PSTR_ENTRY(STR_NOISE_RUN,   "Noise run: ")
+PSTR_ENTRY(STR_NOISE_QUIET, "Noise quiet: ")
+PSTR_ENTRY(STR_CTRL_SP,     "SP ")
+PSTR_ENTRY(STR_CTRL_PV,     " PV ")
+PSTR_ENTRY(STR_CTRL_ISR,    "ISR")
+PSTR_ENTRY(STR_CTRL_JIT,    "jit ")
+PSTR_ENTRY(STR_SCAN_MV,     "mV T")
@@ -0,0 +1,22 @@
+#ifndef __ZST_RGB_FADE_CONFIG__
+#define __ZST_RGB_FADE_CONFIG__
+
+#include "zst-timer1-pwm.h"
+
+// Red on OC0A (Timer0, 8 bit), green and blue on OC1A/OC1B (Timer1, PWM1_BITS)
+#define FADE_SET_R(v) (OCR0A = (v) >> 8)
+#if ADC_CONTROL
+#define FADE_SET_G(v) ((void) (v))     // green belongs to the control loop
+#else
+#define FADE_SET_G(v) PWM1_SetLevel(PWM1_A, (v))
+#endif
+#define FADE_SET_B(v) PWM1_SetLevel(PWM1_B, (v))
+
+// Fade steps from the Timer0 overflow (fast PWM without prescaler:
+// 31250/s at 8MHz, above the audible range)
+#define FADE_vect TIM0_OVF_vect
+#define FADE_TIMSK TIMSK0
+#define FADE_TOIE TOIE0
+#define FADE_OVF_HZ (F_CPU / 256)
+
+#endif
@@ -7,19 +7,191 @@
  *
  * The ADC reads the values of a potentiometer
  * on PA7/ADC7 and displays the percentage on
- * the LCD display.
+ * the LCD display, followed by a bar graph made
+ * of custom CGRAM characters. The ADC runs in
+ * the background (free running, interrupt) and
+ * averages 16 conversions into a 12 bit result.
+ * The displayed value goes through a 1Hz low pass
+ * biquad filter (zst-dsp.h) at the 10Hz refresh.
+ * Set ADC_QUIET to 1 to read it in ADC Noise
+ * Reduction sleep instead (PWM stops ~1.7ms).
+ *
+ * Set ADC_NOISE_TEST to 1 to measure the noise
+ * (RMS, in LSB of the 12 bit result) of 64 results
+ * in free running and in noise reduction mode at
+ * startup, with the PWM running. Measure the supply
+ * current meanwhile for the current per conversion.
  *
  * 3 PWM channels are used for cycling the RGB
  * backlight brightness of the LCD display.
  * PWM inverting mode is used as the backlights
- * are common anode and active-LOW.
+ * are common anode and active-LOW. The colours
+ * fade smoothly in the background (Timer0
+ * overflow interrupt, gamma corrected), so the
+ * display is updated every 100ms. Red uses 8 bit
+ * Timer0 PWM at 31.2kHz, green and blue Timer1
+ * PWM at 20kHz (400 steps, zst-timer1-pwm.h):
+ * both above the audible range. The price is
+ * resolution: 400 steps is ~8.6 bits, so the
+ * darkest steps of the 16 bit gamma table merge.
+ * 10 bits need 1024 counts per period, 7.8kHz at
+ * 8MHz, which can whine: set PWM1_HZ=7812 and
+ * PWM1_BITS=10 in CMakeLists.txt for that.
+ *
+ * Build with -DADC_CONTROL=1 (CMakeLists.txt) to
+ * hold the green LED brightness with a PI loop
+ * instead: ADC7 measures it (light sensor or
+ * current sense resistor), the Timer0 overflow
+ * starts the conversions (every 4th overflow, as
+ * a conversion takes longer) and the ADC interrupt
+ * writes OCR1A, 7812 times/s. The setpoint steps
+ * every 3s; the LCD shows setpoint, input, and the
+ * longest interrupt and the jitter in CPU cycles.
+ * Gains are in include/zst-adc-control-config.h.
+ * A '!' after the interrupt length: some runs
+ * started too late to be timed (after the next
+ * trigger), they are left out of the figures.
+ *
+ * Build with -DADC_SCAN_CHANNELS=3 (CMakeLists.txt)
+ * to scan 3 inputs instead (zst-adc.h scan mode):
+ * the potentiometer (16 conversions averaged), the
+ * 1.1V bandgap against VCC and the temperature
+ * sensor against 1.1V (8 settling conversions
+ * after each reference change). The LCD shows the
+ * potentiometer, VCC in mV, the raw temperature
+ * and the scans/s.
  */
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 #include <string.h>
 #include <stdlib.h>
-#include "zst-lcd-lib.h"
+#include "zst-adc.h"
+#include "zst-dsp.h"
+#include "zst-hd44780.h"
+#include "zst-lcd-cgram.h"
+#include "zst-pstr.h"
+#include "zst-rgb-fade.h"
+#include "zst-timer1-pwm.h"
+
+#define ADC_CHANNEL 7 // potentiometer on PA7/ADC7
+#define ADC_QUIET 0
+#define ADC_NOISE_TEST 0
+#define NOISE_SAMPLES 64
+
+#define FADE_MS 2000 // time of each backlight fade
+
+#if (ADC_CONTROL || ADC_SCAN_CHANNELS) && (ADC_QUIET || ADC_NOISE_TEST)
+    #error "ADC_QUIET and ADC_NOISE_TEST need the free running ADC (ADC_CONTROL and ADC_SCAN_CHANNELS 0)"
+#endif
+
+#if ADC_SCAN_CHANNELS
+#define SCAN_POT 0
+#define SCAN_BANDGAP 1
+#define SCAN_TEMP 2
+
+/* Potentiometer, 1.1V bandgap (VCC reference), temperature sensor (1.1V reference) */
+static const ADC_ScanChannel SCAN[] = {
+    {ADC_REF_VCC | ADC_CHANNEL, 0, 4},
+    {ADC_REF_VCC | ADC_CH_BANDGAP, 8, 2},
+    {ADC_REF_1V1 | ADC_CH_TEMP, 8, 2},
+};
+
+#if ADC_SCAN_CHANNELS < 3
+    #error "The scan demo needs ADC_SCAN_CHANNELS 3"
+#endif
+#elif !ADC_CONTROL
+#if ADC_MAX > 32767
+    #error "The display filter takes 16 bit signed values: ADC_OVERSAMPLE_BITS 5 at most"
+#endif
+
+/* Butterworth low pass, cutoff 1/10 of the 10Hz display refresh */
+static const DSP_BiquadCoef LOW_PASS PROGMEM = {1105, 2210, 1105, -18727, 6763}; // Q14
+#endif
+
+/* Backlight colours, faded from one to the next */
+static const uint8_t COLORS[][3] PROGMEM = {
+    {255,   0,   0}, // red
+    {  0, 255,   0}, // green
+    {  0,   0, 255}, // blue
+    {255, 255, 255}, // white
+    {  0,   0,   0}, // off
+};
+
+/* Cycle the RGB backlights: post the next colour when a fade ends */
+static void fade_next(uint8_t *color) {
+    if (FADE_Busy())
+        return;
+    FADE_To(pgm_read_byte(&COLORS[*color][0]),
+            pgm_read_byte(&COLORS[*color][1]),
+            pgm_read_byte(&COLORS[*color][2]), FADE_MS);
+    if (++*color == sizeof(COLORS) / sizeof(COLORS[0]))
+        *color = 0;
+}
+
+/* Unsigned number right aligned in 3 chars */
+static void print_number3(uint16_t n) {
+    if (n < 100)
+        LCD_Char(' ');
+    if (n < 10)
+        LCD_Char(' ');
+    LCD_Integer(n);
+}
+
+#if ADC_CONTROL || ADC_SCAN_CHANNELS
+/* Unsigned number right aligned in 4 chars */
+static void print_number4(uint16_t n) {
+    if (n < 1000)
+        LCD_Char(' ');
+    print_number3(n);
+}
+#endif
+
+#if ADC_SCAN_CHANNELS
+/* Potentiometer and bar graph, VCC, temperature and scans/s */
+static void show_scan(void) {
+    uint16_t pot = ADC_ScanRead(SCAN_POT);
+    uint16_t bandgap = ADC_ScanRead(SCAN_BANDGAP);
+
+    LCD_MoveCursor(0, 0);
+    LCD_Message_P(STR_ADC);
+    print_number3((uint32_t) pot * 100 / 1023);
+    LCD_BarGraph(8, 0, 8, pot, 1023);
+    LCD_MoveCursor(0, 1);
+    print_number4(bandgap ? 1125300UL / bandgap : 0); // 1.1V * 1023 in mV / value
+    LCD_Message_P(STR_SCAN_MV);
+    print_number3(ADC_ScanRead(SCAN_TEMP));
+    LCD_Char(' ');
+    print_number4(ADC_ScanRate());
+}
+#endif
+
+#if ADC_CONTROL
+#define SETPOINT_STEPS 30 // 3s of 100ms display refreshes
+
+/* Setpoints of the control loop, 0 to 1023 */
+static const uint16_t SETPOINTS[] PROGMEM = {200, 800, 500, 1000};
+
+/* Setpoint, input, and the loop timing since the previous call */
+static void show_control(const uint16_t setpoint) {
+    ADC_ControlTiming timing;
+
+    ADC_ControlGetTiming(&timing);
+    LCD_MoveCursor(0, 0);
+    LCD_Message_P(STR_CTRL_SP);
+    print_number4(setpoint);
+    LCD_Message_P(STR_CTRL_PV);
+    print_number4(ADC_Read());
+    LCD_MoveCursor(0, 1);
+    LCD_Message_P(STR_CTRL_ISR);
+    print_number4(timing.isr_max);
+    LCD_Char(timing.invalid ? '!' : ' '); // runs left out
+    LCD_Message_P(STR_CTRL_JIT);
+    print_number4(timing.delay_max - timing.delay_min);
+}
+#endif
 
 /* 
  * ----------------------------------
@@ -45,7 +217,66 @@
  * ----------------------------------
  */
 
+#if ADC_NOISE_TEST
+static uint16_t isqrt(uint32_t x) {
+    uint32_t r = 0, bit = 1UL << 30;
+
+    while (bit > x)
+        bit >>= 2;
+    while (bit) {
+        if (x >= r + bit) {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+/* RMS noise of NOISE_SAMPLES results, in tenths of a LSB */
+static uint16_t noise_rms10(uint8_t quiet) {
+    uint16_t first = 0, value;
+    int16_t d;
+    int32_t sum = 0;
+    uint32_t squares = 0;
+    uint8_t i;
+
+    for (i = 0; i < NOISE_SAMPLES; i++) {
+        value = quiet ? ADC_ReadQuiet(ADC_CHANNEL) : ADC_Wait();
+        if (i == 0)
+            first = value; // differences stay small, no overflow
+        d = value - first;
+        sum += d;
+        squares += (int32_t) d * d;
+    }
+    // variance = (sum of squares - sum^2 / n) / n
+    return isqrt((squares - (uint32_t) (sum * sum) / NOISE_SAMPLES) * 100 / NOISE_SAMPLES);
+}
+
+static void noise_test(void) {
+    uint16_t run = noise_rms10(0);
+    uint16_t quiet = noise_rms10(1);
+
+    LCD_Clear();
+    LCD_MoveCursor(0, 0);
+    LCD_Message_P(STR_NOISE_RUN);
+    LCD_Integer(run / 10);
+    LCD_Char('.');
+    LCD_Integer(run % 10);
+    LCD_MoveCursor(0, 1);
+    LCD_Message_P(STR_NOISE_QUIET);
+    LCD_Integer(quiet / 10);
+    LCD_Char('.');
+    LCD_Integer(quiet % 10);
+    _delay_ms(5000);
+}
+#endif
+
 int main(void) {
+    char text[11];
+
     DDRA = 0x0F; // PA0-3 as output
     DDRB = 0x03; // PB0-1 as output
 
@@ -55,116 +286,122 @@ int main(void) {
     DDRA |= _BV(PA5); // OC1B
 
 
+#if ADC_SCAN_CHANNELS
+    /* Setup ADC: scan the list in the background */
+    ADC_ScanStart(SCAN, sizeof(SCAN) / sizeof(SCAN[0]));
+#elif !ADC_CONTROL
     /* Setup ADC */
-    DIDR0 |= _BV(ADC7D); // Disable digital input on ADC7
-    ADMUX |= 7; // Select ADC7 pin
-    ADMUX &= ~(_BV(REFS0) | _BV(REFS0)); // VCC used as analog reference
-
-    ADCSRA |= _BV(ADEN); // enable ADC
-    ADCSRB &= ~_BV(ADLAR); // Disable left adjusted result in ADC Data Register -> result is presented right adjusted
+    ADC_Init(ADC_CHANNEL); // ADC7, VCC reference, free running in the background
+#endif
+    sei(); // for the ADC, the PWM updates and the fades
 
     /* Setup LCD */
     LCD_Init();
     LCD_MoveCursor(0, 0);
-    LCD_Message("Hello World."); // welcome message
-    _delay_ms(2000); // wait
+    LCD_Message_P(STR_HELLO); // welcome message
 
     /* Setup PWM: OC0 */
     TCCR0A |= _BV(WGM00) | _BV(WGM01); // Mode 3 - Fast PWM
     TCCR0A |= _BV(COM0A0) | _BV(COM0A1); // Enable OC0A Inverting mode for fast PWM
     // TCCR0A |= _BV(COM0B0) | _BV(COM0B1); // Enable OC0B Inverting mode for fast PWM
-    TCCR0B |= _BV(CS00); // No prescaler, begin PWM
-    // TIMSK0 is for interrupts - not used
-    // TIFR0 is for interrupt flags - not used
+    TCCR0B |= _BV(CS00); // no prescaler (31.2KHz PWM, FADE_OVF_HZ), begin PWM
+    // TIMSK0 is for interrupts - used by the fades
 
     /* Set PWM value */
     OCR0A = 128; // Compared with TCNT0 which is counting in real time;
 
     /* Setup PWM: OC1 */
-    //Mode 14  - fast PWM (TOP is ICR1)
-    TCCR1A |= _BV(WGM11);
-    TCCR1B |= _BV(WGM12);
-    TCCR1B |= _BV(WGM13);
-    ICR1 = 0xFF; // Setup TOP for OC1
+    // Mode 14 - fast PWM (TOP is ICR1), TOP and prescaler solved
+    // from PWM1_HZ and PWM1_BITS (20KHz, TOP 399 at 8MHz: CMakeLists.txt)
+    PWM1_Init(PWM1_OUT_A_INV | PWM1_OUT_B_INV); // Inverting mode for fast PWM
+
+    /* Set PWM value */
+    PWM1_SetLevel(PWM1_A, 0x8000);
+    PWM1_SetLevel(PWM1_B, 0x8000);
 
-    TCCR1A |= _BV(COM1B0) | _BV(COM1B1); // Enable OC1B Inverting mode for fast PWM
-    TCCR1A |= _BV(COM1A0) | _BV(COM1A1); // Enable OC1A Inverting mode for fast PWM
-    TCCR1B |= _BV(CS10); // No prescaler, begin PWM
+    /* Show the Timer1 PWM really running */
+    LCD_MoveCursor(0, 1);
+    LCD_Message_P(STR_PWM1);
+    LCD_Message(ultoa(PWM1_Hz(), text, 10));
+    LCD_Message_P(STR_HZ);
+    LCD_Integer(PWM1_Bits());
+    LCD_Message_P(STR_BITS);
+    _delay_ms(2000);
 
-    /*
-    // Mode 5 - fast PWM (TOP is 0xFF, 8 bit)
-    TCCR1A |= _BV(WGM10); TCCR1B |= _BV(WGM12); 
-    */
+#if ADC_NOISE_TEST
+    noise_test(); // with the PWM running
+#endif
 
-    /* Set PWM value */
-    OCR1A = 128;
-    OCR1B = 128;
+    FADE_Init(); // takes over OCR0A and the Timer1 channels
 
+#if ADC_CONTROL
+    /* Setup the control loop, started by the Timer0 overflow (after FADE_Init: its interrupt clears TOV0 for the next trigger) */
+    uint8_t step = 0, setpoint = 0, color = 0;
+    ADC_ControlStart(ADC_CHANNEL, pgm_read_word(&SETPOINTS[0]));
 
-    uint8_t count = 0;
-    uint8_t type = 0;
-    uint16_t ADCresult = 0;
+    LCD_Clear();
     while(1) {
-        OCR0A = 0;
-        OCR0B = 0;
-        OCR1B = 0;
-        OCR1A = 0;
-        count = 0;
-        
-        LCD_Clear();
-        LCD_MoveCursor(0, 0);
-        LCD_Message("ADC: ");
-
-        if (((ADCSRA >> ADSC) & 1) == 0) { // if conversion is done
-            /**
-             * Single Conversion
-             * A single conversion is started by writing a logical one to 
-             * the ADC Start Conversion bit, ADSC.
-             * This bit stays high as long as the conversion is in progress
-             * ADCL must be read first, then ADCH, to ensure that the content
-             * of the data registers belongs to the same conversion.
-             */
-            ADCresult = ADCL + (ADCH << 8); // Read previous conversion
-            ADCSRA |= _BV(ADSC); // Start next conversion
-            LCD_Integer((ADCresult/1023.0) * 100);
-        } else {
-            LCD_Message("Converting: ");
+        if (++step == SETPOINT_STEPS) {
+            step = 0;
+            if (++setpoint == sizeof(SETPOINTS) / sizeof(SETPOINTS[0]))
+                setpoint = 0;
+            ADC_ControlSet(pgm_read_word(&SETPOINTS[setpoint]));
         }
+        show_control(pgm_read_word(&SETPOINTS[setpoint]));
 
-        /* Cycle the RGB backlights */
-        if (type == 0) {
-            do {
-                LCD_MoveCursor(0, 1);
-                LCD_Message("R: ");
-                LCD_Integer(count);
-                OCR0A = count;
-                count+=10;
-                _delay_ms(50);
-            } while (count < 250);
-            type++;
-            continue;
-        } else if (type == 1) {
-            do {
-                LCD_MoveCursor(0, 1);
-                LCD_Message("G: ");
-                LCD_Integer(count);
-                OCR1A = count;
-                count+=10;
-                _delay_ms(50);
-            } while (count < 250);
-            type++;
-            continue;
-        } else if (type == 2) {
-            do {
-                LCD_MoveCursor(0, 1);
-                LCD_Message("B: ");
-                LCD_Integer(count);
-                OCR1B = count;
-                count+=10;
-                _delay_ms(50);
-            } while (count < 250);
-            type = 0;
-            continue;
-        }
+        fade_next(&color); // red and blue only, green is the loop output
+
+        _delay_ms(100); // display refresh, the loop runs in the ADC interrupt
+    }
+#elif ADC_SCAN_CHANNELS
+    uint8_t color = 0;
+
+    LCD_Clear();
+    while(1) {
+        show_scan();
+        fade_next(&color);
+        _delay_ms(100); // display refresh, the scan runs in the ADC interrupt
+    }
+#else
+    uint8_t color = 0;
+    uint8_t r, g, b;
+    int16_t ADCresult;
+    DSP_Biquad smooth;
+
+    // Start the filter settled at the first result
+#if ADC_QUIET
+    DSP_BiquadInit(&smooth, &LOW_PASS, ADC_ReadQuiet(ADC_CHANNEL));
+#else
+    DSP_BiquadInit(&smooth, &LOW_PASS, ADC_Wait());
+#endif
+    LCD_Clear();
+    while(1) {
+        LCD_MoveCursor(0, 0);
+        LCD_Message_P(STR_ADC);
+
+#if ADC_QUIET
+        ADCresult = DSP_BiquadPut(&smooth, ADC_ReadQuiet(ADC_CHANNEL)); // 0 to ADC_MAX
+#else
+        ADCresult = DSP_BiquadPut(&smooth, ADC_Read()); // latest average, 0 to ADC_MAX
+#endif
+        if (ADCresult < 0) // the filter overshoots a little on steps
+            ADCresult = 0;
+        if (ADCresult > (int16_t) ADC_MAX)
+            ADCresult = ADC_MAX;
+        print_number3((uint32_t) ADCresult * 100 / ADC_MAX);
+        LCD_BarGraph(8, 0, 8, ADCresult, ADC_MAX); // 8 chars = 40 steps
+
+        fade_next(&color);
+        FADE_Get(&r, &g, &b);
+        LCD_MoveCursor(0, 1);
+        LCD_Message_P(STR_RGB);
+        print_number3(r);
+        LCD_Char(' ');
+        print_number3(g);
+        LCD_Char(' ');
+        print_number3(b);
+
+        _delay_ms(100); // display refresh, the fades run in the background
     }
-}
\ No newline at end of file
+#endif
+}
@@ -0,0 +1,14 @@
+#ifndef __ZST_BAM_CONFIG__
+#define __ZST_BAM_CONFIG__
+
+// 8 LEDs on PC0-PC7, 8 bit duty, 122Hz refresh at 8MHz.
+// The BAM interrupt can wait for the DDS interrupt (~90 cycles) and
+// BAM_Set (a few cycles with interrupts off), then needs ~20 cycles
+// to write OCR1A: ~115 cycles, more than a 128 cycle slot allows
+// with margin, well within 256.
+#define BAM_BITS 8
+#define BAM_TICK 256
+#define BAM_PORT0 PORTC
+#define BAM_PORT0_PINS 0xFF
+
+#endif
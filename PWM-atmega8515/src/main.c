@@ -1,18 +1,52 @@
 /* 
  * ATmega8515
  * PWM for LED on PB0/OC0
+ *
+ * The PWM duty cycle is set by direct digital
+ * synthesis (see zst-dds.h): the Timer0 overflow
+ * interrupt steps through a waveform table at an
+ * exact frequency with 0.001Hz resolution.
+ *
+ * DDS_AUDIO 0: the LED breathes (0.50Hz sine).
+ * DDS_AUDIO 1: 440Hz tone, changing between sine,
+ * triangle and saw every 2s. Filter PB0 with a
+ * 1k resistor + 100nF capacitor to ground and
+ * feed it to an amplifier.
+ *
+ * 8 more LEDs on PC0-PC7 are dimmed in software by
+ * bit angle modulation on Timer1 (see zst-bam.h):
+ * a sine wave runs along them, one step every 20ms.
  */
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
+#include "zst-bam.h"
+#include "zst-dds.h"
+
+#define DDS_AUDIO 0
+
+static void bam_wave(const uint8_t phase) {
+    uint8_t i;
+    for (i = 0; i < 8; i++)
+        BAM_Set(i, pgm_read_byte(&DDS_SINE[(uint8_t) (phase + i * 32)]));
+}
 
 int main(void) {
+    uint8_t phase = 0;
+#if DDS_AUDIO
+    uint8_t steps = 0, wave = 0;
+#endif
+
     DDRB |= 0x01; // Set PB0 as output
+    DDRC = 0xFF;  // PC0-PC7 LEDs
 
     // Mode 1 - PWM, Phase Correct
     TCCR0 |= _BV(WGM00);
 
     // Clock select - no prescaler
+    // 8MHz / 510 = 15686 PWM periods (DDS samples) per second
     TCCR0 |= _BV(CS00);
 
     // COM01:0 = 0b10
@@ -20,11 +54,30 @@ int main(void) {
     // Set OC0 on Compare Match when downcounting.
     TCCR0 |= _BV(COM01);
 
+    DDS_Init(DDS_SINE);
+    BAM_Init();
+    sei();
+
+#if DDS_AUDIO
+    DDS_SetTuning(DDS_TUNING(440)); // A4
     while(1) {
-        for (uint8_t x = 0; x < 255; x += 10) {
-            OCR0 = x;
-            _delay_ms(50);
+        bam_wave(phase += 4);
+        _delay_ms(20);
+        if (++steps == 100) { // 2s
+            static const uint8_t *const waves[3] = { DDS_SINE, DDS_TRIANGLE, DDS_SAW };
+            steps = 0;
+            if (++wave == 3)
+                wave = 0;
+            DDS_Wave(waves[wave]);
         }
     }
+#else
+    DDS_SetFrequency(50); // 0.50Hz
+    while(1) {
+        // the PB0 LED is all done by the interrupt
+        bam_wave(phase += 4);
+        _delay_ms(20);
+    }
+#endif
     return 0;
-}
\ No newline at end of file
+}
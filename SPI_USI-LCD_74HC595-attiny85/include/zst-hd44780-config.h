@@ -0,0 +1,17 @@
+#ifndef __ZST_LCD_HD44780_CONFIG__
+#define __ZST_LCD_HD44780_CONFIG__
+
+// LCD connected through a 74HC595 on the USI (see zst-hd44780.h)
+// Change to LCD_BACKEND_PCF8574 to compare with the I2C backpack.
+#define LCD_BACKEND LCD_BACKEND_74HC595
+
+// USI three-wire mode: DO -> SER, USCK -> SRCLK
+#define LCD_SPI_DDR DDRB
+#define LCD_SPI_MOSI PB1
+#define LCD_SPI_SCK PB2
+// Latch -> RCLK
+#define LCD_LATCH_PORT PORTB
+#define LCD_LATCH_DDR DDRB
+#define LCD_LATCH PB3
+
+#endif
@@ -0,0 +1,114 @@
+/* 
+ * ATtiny85
+ *
+ * Interface with a HD44780 LCD display using
+ * only 3 pins through a 74HC595 shift register.
+ * The USI module in three-wire mode shifts the
+ * data out at F_CPU/2 (4MHz).
+ *
+ * The speed of the LCD library is measured
+ * with Timer0 and displayed in characters per
+ * second. Set LCD_BACKEND to LCD_BACKEND_PCF8574
+ * in zst-hd44780-config.h to measure the same
+ * display on a PCF8574 I2C backpack instead.
+ *
+ * Expected at 8MHz: 74HC595 ~10us to shift a
+ * char + 40us for the LCD to execute it, about
+ * 20000 chars/s. The I2C backpack needs a
+ * 6 byte I2C transaction per char (~500us),
+ * about 2000 chars/s.
+ *
+ * Connections (74HC595):
+ *     PB1 - DO   -> SER   (pin 14)
+ *     PB2 - USCK -> SRCLK (pin 11)
+ *     PB3 - out  -> RCLK  (pin 12)
+ *     Q0 - RS, Q2 - En, Q4-Q7 - DB4-DB7
+ *
+ * Connections (PCF8574):
+ *     PB2 - I2C SCL
+ *     PB0 - I2C SDA
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <stdlib.h>
+#include "zst-hd44780.h"
+
+#if LCD_BACKEND == LCD_BACKEND_PCF8574
+#include "TinyWireM.h"
+
+#define LCD_I2C_ADDRESS (0x78 >> 1)
+
+void LCD_I2C_Write(const uint8_t *data, uint8_t len) {
+    TinyWireM.write(LCD_I2C_ADDRESS, data, len);   // sent in place, no copy
+}
+#endif
+
+#define BENCH_CHARS 256 // 16 rows of 16 chars
+#define TIMER0_PRESCALER 64 // 8us per tick at 8MHz
+
+volatile uint16_t timer0_overflows = 0;
+
+ISR(TIMER0_OVF_vect) {
+    timer0_overflows++;
+}
+
+// Timer0 ticks since start (TCNT0 extended with the overflow count)
+uint32_t Timer0_Ticks(void) {
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t overflows = timer0_overflows;
+    uint8_t count = TCNT0;
+    if ((TIFR & _BV(TOV0)) && count < 255) overflows++; // overflow not handled yet
+    SREG = sreg;
+    return ((uint32_t) overflows << 8) | count;
+}
+
+int main(void) {
+#if LCD_BACKEND == LCD_BACKEND_PCF8574
+    /* Setup I2C with USI */
+    TinyWireM.begin();
+#endif
+
+    /* Setup LCD */
+    LCD_Init();
+    LCD_MoveCursor(0, 0);
+#if LCD_BACKEND == LCD_BACKEND_PCF8574
+    LCD_Message_P(PSTR("PCF8574 I2C"));
+#else
+    LCD_Message_P(PSTR("74HC595 USI"));
+#endif
+    _delay_ms(2000); // wait
+
+    /* Setup Timer0: normal mode, counting at F_CPU/64 */
+    TCCR0A = 0;
+    TCCR0B = _BV(CS01) | _BV(CS00);
+    TIMSK |= _BV(TOIE0); // Overflow interrupt
+    sei();
+
+    while (1) {
+        uint32_t start, ticks;
+        uint8_t i, j;
+
+        /* Fill line 0 over and over */
+        start = Timer0_Ticks();
+        for (i = 0; i < BENCH_CHARS / 16; i++) {
+            LCD_MoveCursor(0, 0);
+            for (j = 0; j < 16; j++) {
+                LCD_Char('A' + i);
+            }
+        }
+        ticks = Timer0_Ticks() - start;
+
+        /* chars per second = chars / (ticks * prescaler / F_CPU) */
+        LCD_MoveCursor(0, 1);
+        LCD_Message_P(PSTR("c/s: "));
+        char st[12] = "";
+        ultoa((uint32_t) BENCH_CHARS * (F_CPU / TIMER0_PRESCALER) / ticks, st, 10);
+        LCD_Message(st);
+        LCD_Message_P(PSTR("   "));
+
+        _delay_ms(1000);
+    }
+}
@@ -2,11 +2,13 @@
 #define __ZST_USART__LIB__
 
 #include <util/setbaud.h>
+#include <avr/pgmspace.h>
 #include <stdio.h>
 
 void uart_putchar(char c, FILE *stream);
 char uart_getchar(FILE *stream);
 void uart_init(void);
+void uart_puts_P(const char *s);
 
 /* http://www.ermicro.com/blog/?p=325 */
 FILE uart_output = FDEV_SETUP_STREAM(uart_putchar, NULL, _FDEV_SETUP_WRITE);
@@ -38,6 +40,13 @@ void uart_putchar(char c, FILE *stream) {
     UDR0 = c;
 }
 
+/* Send a string stored in flash (PSTR), without going through stdout */
+void uart_puts_P(const char *s) {
+    char c;
+    while ((c = pgm_read_byte(s++)))
+        uart_putchar(c, NULL);
+}
+
 char uart_getchar(FILE *stream) {
     loop_until_bit_is_set(UCSR0A, RXC0);
     return UDR0;
@@ -24,7 +24,7 @@ int main(void) {
     	PORTB ^= _BV(1);
     	_delay_ms(100);
         if ((PINB & _BV(PB0)) == 0) {
-            printf("Hello, you pressed the button %d times\n", count);
+            printf_P(PSTR("Hello, you pressed the button %d times\n"), count); // format string stays in flash
             count++;
         }
     }
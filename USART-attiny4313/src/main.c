@@ -6,6 +6,8 @@
  *
  * Create custom `putchar`, `puts`, and
  * `printf` functions for USART.
+ * The `_P` versions take strings stored in
+ * flash (PSTR) so they don't use up SRAM.
  */
 
 #include <avr/io.h>
@@ -49,6 +51,12 @@ void usart_puts(char * s) {
         usart_putch(*s++);
 }
 
+void usart_puts_P(const char * s) {
+    char c;
+    while ((c = pgm_read_byte(s++)))
+        usart_putch(c);
+}
+
 void usart_printf(const char * format, ...) {
     va_list arg_list;
     va_start(arg_list, format);
@@ -58,6 +66,20 @@ void usart_printf(const char * format, ...) {
     va_end(arg_list);
 }
 
+int usart_stream_putch(char c, FILE *stream) {
+    usart_putch(c);
+    return 0;
+}
+
+FILE usart_stream = FDEV_SETUP_STREAM(usart_stream_putch, NULL, _FDEV_SETUP_WRITE);
+
+void usart_printf_P(const char * format, ...) {
+    va_list arg_list;
+    va_start(arg_list, format);
+    vfprintf_P(&usart_stream, format, arg_list); // straight to USART, no 64 byte buffer
+    va_end(arg_list);
+}
+
 int main(void) {
     DDRD |= _BV(6);
 
@@ -68,8 +90,8 @@ int main(void) {
     uint8_t count = 0;
     while (1) {
         _delay_ms(500);
-        usart_puts(PSTR("Hello\n"));
-        usart_printf(PSTR("We have looped %d times.\n"), count++);
+        usart_puts_P(PSTR("Hello\n"));
+        usart_printf_P(PSTR("We have looped %d times.\n"), count++);
     }
 }
 
@@ -0,0 +1,389 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 winlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <avr/interrupt.h>
+#include "SimpleDHT.h"
+
+#if !defined(__AVR_ATtiny25__) && !defined(__AVR_ATtiny45__) && !defined(__AVR_ATtiny85__)
+    #error "SimpleDHT11: pin change interrupt set up for the ATtiny25/45/85 only"
+#endif
+
+#if DHT_TIMER == 0
+    #define DHT_TCNT            TCNT0
+    #define DHT_TOIE            TOIE0
+    #define DHT_OVF_vect        TIMER0_OVF_vect
+#elif DHT_TIMER == 1
+    #define DHT_TCNT            TCNT1
+    #define DHT_TOIE            TOIE1
+    #define DHT_OVF_vect        TIMER1_OVF_vect
+#else
+    #error "SimpleDHT11: DHT_TIMER must be 0 or 1"
+#endif
+
+// DHT11 falling edges:
+//    1. start of the response (PULL LOW 80us)
+//    2. end of the response (PULL HIGH 80us)
+//    3-42. end of each bit (PULL LOW 50us, PULL HIGH 26-28us or 70us)
+// The DHT22 answers the same way.
+#define DHT_EDGE_FIRST_BIT      2
+#define DHT_EDGES               (DHT_EDGE_FIRST_BIT + 40)
+
+// Shared with the pin change interrupt, one entry per sensor
+static volatile uint8_t dht_edges[DHT_MAX_CHANNELS];    // falling edges seen
+static volatile uint8_t dht_rise[DHT_MAX_CHANNELS];     // timer at the last rising edge
+static volatile uint8_t dht_data[DHT_MAX_CHANNELS][5];
+static uint8_t dht_mask[DHT_MAX_CHANNELS];
+static uint8_t dht_count;
+static volatile uint8_t *dht_pin;
+static volatile uint8_t dht_listen;     // pins still sending bits
+static uint8_t dht_last;                // port at the last interrupt
+static const DHTPort *dht_port;         // sensors being read
+
+// Background state machine (timer overflow)
+#define DHT_IDLE                0   // waiting for the next reading
+#define DHT_START               1   // start signal: lines held low 18ms
+#define DHT_CAPTURE             2   // the pin change interrupt decodes the bits
+
+static volatile uint32_t dht_ticks;     // timer overflows since begin()
+static uint8_t dht_state;
+static uint32_t dht_due;                // tick of the next step
+static uint32_t dht_started;            // tick the current reading started
+static uint32_t dht_interval;           // ticks between readings (longer with a DHT22)
+static const DHTPort *dht_bg;           // sensors read in the background (NULL: none)
+static DHTReading dht_reading[DHT_MAX_CHANNELS];
+static volatile uint8_t dht_valid;      // bit per sensor: dht_reading holds a valid reading
+
+// SimpleDHT11: one sensor
+static DHTPort dht_single;
+
+ISR(PCINT0_vect) {
+    uint8_t now = DHT_TCNT;             // first, so the latency is the same for both edges
+    uint8_t v = *dht_pin;               // one read for every sensor
+    uint8_t changed = (v ^ dht_last) & dht_listen;
+    uint8_t ch, m, edges;
+
+    dht_last = v;
+    for (ch = 0; ch < dht_count; ch++) {
+        m = dht_mask[ch];
+        if (!(changed & m))
+            continue;
+        if (v & m) {                    // rising: a high pulse starts
+            dht_rise[ch] = now;
+            continue;
+        }
+        edges = dht_edges[ch];
+        if (edges >= DHT_EDGE_FIRST_BIT) { // falling: the high pulse was a bit
+            uint8_t i = (edges - DHT_EDGE_FIRST_BIT) >> 3;
+            dht_data[ch][i] = (dht_data[ch][i] << 1) | ((uint8_t) (now - dht_rise[ch]) > DHT_TICKS(DHT_BIT_THRESHOLD_US));
+        }
+        if (++edges == DHT_EDGES) {     // all 40 bits, stop listening
+            dht_listen &= ~m;
+            PCMSK &= ~m;
+        }
+        dht_edges[ch] = edges;
+    }
+}
+
+// Start signal part 1: PULL LOW every sensor (for 18ms), and clear the decoder
+static void dht_pull_low(const DHTPort &p) {
+    uint8_t ch, i, all = 0;
+
+    dht_port = &p;
+    dht_count = p.count < DHT_MAX_CHANNELS ? p.count : DHT_MAX_CHANNELS;
+    for (ch = 0; ch < dht_count; ch++) {
+        dht_mask[ch] = 1<<p.pos[ch];
+        all |= dht_mask[ch];
+        for (i = 0; i < 5; i++)
+            dht_data[ch][i] = 0;
+        dht_edges[ch] = 0;
+    }
+    PCMSK &= ~all;
+    dht_listen = 0;
+    dht_pin = p.pin;
+
+    *p.ddr |= all;      //pinMode(pin, OUTPUT);
+    *p.port &= ~all;    //digitalWrite(pin, LOW);
+}
+
+// Start signal part 2: PULL HIGH 20-40us, SET TO INPUT, then the
+// interrupt decodes the answers
+static void dht_release(void) {
+    const DHTPort &p = *dht_port;
+    uint8_t ch, all = 0;
+
+    for (ch = 0; ch < dht_count; ch++)
+        all |= dht_mask[ch];
+
+    *p.port |= all;     //digitalWrite(pin, HIGH);
+    _delay_us(30);
+    *p.ddr &= ~all;     //pinMode(pin, INPUT);
+
+    dht_last = *p.pin;
+    dht_listen = all;
+    GIFR = (1<<PCIF);
+    PCMSK |= all;
+    GIMSK |= (1<<PCIE);
+}
+
+// Stop listening when the time is up
+static void dht_stop(void) {
+    PCMSK &= ~dht_listen;
+    dht_listen = 0;
+}
+
+// Check the decoded bits of sensor ch: 0 or the error code (see finish)
+static int dht_check(uint8_t ch) {
+    volatile uint8_t *d = dht_data[ch];
+
+    if (dht_edges[ch] == 0) {
+        return 100;
+    }
+    if (dht_edges[ch] < DHT_EDGE_FIRST_BIT) {
+        return 101;
+    }
+    if (dht_edges[ch] < DHT_EDGES) {
+        return 103;
+    }
+
+    // humidity, humidity decimal, temperature, temperature decimal, checksum
+    byte expect = d[0] + d[1] + d[2] + d[3];
+    if (d[4] != expect) {
+        return 105;
+    }
+    return 0;
+}
+
+// Values of a checked reading of sensor ch
+static void dht_decode(uint8_t ch, DHTReading *r) {
+    volatile uint8_t *d = dht_data[ch];
+
+    if (dht_port->type[ch] == DHT_TYPE_DHT22) {
+        // 16 bit tenths, temperature with a sign bit
+        r->humidity10 = (uint16_t) d[0] << 8 | d[1];
+        r->temperature10 = (int16_t) ((uint16_t) (d[2] & 0x7F) << 8 | d[3]);
+        if (d[2] & 0x80)
+            r->temperature10 = -r->temperature10;
+    } else {
+        r->humidity10 = d[0] * 10 + d[1];
+        r->temperature10 = d[2] * 10 + d[3];
+    }
+    r->humidity = r->humidity10 / 10;
+    r->temperature = r->temperature10 < 0 ? 0 : r->temperature10 / 10;
+}
+
+// Timer overflows to ms
+static uint32_t dht_ms(uint32_t ticks) {
+    return ticks / 1000 * DHT_OVF_US + ticks % 1000 * DHT_OVF_US / 1000;
+}
+
+ISR(DHT_OVF_vect) {
+    uint32_t now = ++dht_ticks;
+    uint8_t ch;
+
+    if (!dht_bg || (int32_t) (now - dht_due) < 0)
+        return;
+
+    switch (dht_state) {
+        case DHT_IDLE:
+            dht_pull_low(*dht_bg);
+            dht_started = now;
+            dht_due = now + DHT_OVF_TICKS(DHT_START_MS);
+            dht_state = DHT_START;
+            break;
+
+        case DHT_START:
+            dht_release();
+            dht_due = now + DHT_OVF_TICKS(DHT_TIMEOUT_MS);
+            dht_state = DHT_CAPTURE;
+            break;
+
+        case DHT_CAPTURE:
+            if (dht_listen && (int32_t) (now - dht_due) < 0)
+                break;
+            dht_stop();
+            for (ch = 0; ch < dht_count; ch++) {
+                DHTReading &r = dht_reading[ch];
+
+                r.error = dht_check(ch);
+                r.attempts++;
+                if (!r.error) {
+                    dht_decode(ch, &r);
+                    r.time = dht_ms(now);
+                    dht_valid |= 1<<ch;
+                }
+            }
+            dht_due = dht_started + dht_interval;
+            dht_state = DHT_IDLE;
+            break;
+    }
+}
+
+// Timer free running (normal mode), read by the pin change interrupt
+static void dht_timer(void) {
+#if DHT_TIMER == 0
+    TCCR0A = 0;
+    TCCR0B = DHT_PRESCALE == 8 ? (1<<CS01) : (1<<CS00);
+#else
+    TCCR1 = DHT_PRESCALE == 8 ? (1<<CS12) : (1<<CS10);
+#endif
+}
+
+// notify every sensor to start:
+//    1. PULL LOW 18ms.
+//    2. PULL HIGH 20-40us.
+//    3. SET TO INPUT.
+static void dht_start(const DHTPort &p) {
+    dht_timer();
+    dht_pull_low(p);
+    _delay_ms(DHT_START_MS);
+    dht_release();
+}
+
+// Wait for the decoder, at most DHT_TIMEOUT_MS
+static void dht_wait(void) {
+    uint16_t wait;
+
+    for (wait = 0; dht_listen && wait < DHT_TIMEOUT_MS * 10; wait++)
+        _delay_us(100);
+    dht_stop();
+}
+
+static void dht_start_background(const DHTPort &p) {
+    uint8_t sreg = SREG;
+    uint32_t interval = DHT_OVF_TICKS(DHT_INTERVAL_MS);
+    uint8_t ch;
+
+    for (ch = 0; ch < p.count && ch < DHT_MAX_CHANNELS; ch++)
+        if (p.type[ch] == DHT_TYPE_DHT22)
+            interval = DHT_OVF_TICKS(DHT22_INTERVAL_MS);
+
+    dht_timer();
+    cli();
+    dht_bg = &p;
+    dht_interval = interval;
+    dht_valid = 0;
+    dht_state = DHT_IDLE;
+    dht_due = dht_ticks + 1;            // first reading right away
+    TIMSK |= (1<<DHT_TOIE);
+    SREG = sreg;
+}
+
+uint8_t DHTMulti::read(const DHTPort &p, DHTReading r[]) {
+    uint8_t ch, ok = 0;
+
+    dht_start(p);
+    dht_wait();
+    for (ch = 0; ch < dht_count; ch++) {
+        r[ch].error = dht_check(ch);
+        r[ch].attempts++;
+        if (!r[ch].error) {
+            dht_decode(ch, &r[ch]);
+            ok++;
+        }
+    }
+    return ok;
+}
+
+void DHTMulti::begin(const DHTPort &p) {
+    dht_start_background(p);
+}
+
+bool DHTMulti::latest(uint8_t ch, DHTReading* r) {
+    uint8_t sreg = SREG;
+    bool valid;
+
+    cli();
+    *r = dht_reading[ch];
+    valid = dht_valid & (1<<ch);
+    SREG = sreg;
+    r->age = valid ? SimpleDHT11::millis() - r->time : 0;
+    return valid;
+}
+
+// One sensor as a DHTPort (DHT11)
+static const DHTPort &dht_one(const pinType &p) {
+    dht_single.ddr = p.ddr;
+    dht_single.pin = p.pin;
+    dht_single.port = p.port;
+    dht_single.count = 1;
+    dht_single.pos[0] = p.pos;
+    dht_single.type[0] = DHT_TYPE_DHT11;
+    return dht_single;
+}
+
+void SimpleDHT11::start(pinType p) {
+    dht_start(dht_one(p));
+}
+
+bool SimpleDHT11::busy() {
+    return dht_listen;
+}
+
+int SimpleDHT11::finish(byte* ptemperature, byte* phumidity, byte pdata[5]) {
+    uint8_t i;
+
+    int ret;
+
+    dht_wait();
+    if ((ret = dht_check(0)) != 0) {
+        return ret;
+    }
+
+    if (pdata) {
+        for (i = 0; i < 5; i++)
+            pdata[i] = dht_data[0][i];
+    }
+    if (ptemperature) {
+        *ptemperature = dht_data[0][2];
+    }
+    if (phumidity) {
+        *phumidity = dht_data[0][0];
+    }
+    return 0;
+}
+
+int SimpleDHT11::read(pinType pt, byte* ptemperature, byte* phumidity, byte pdata[5]) {
+    start(pt);
+    return finish(ptemperature, phumidity, pdata);
+}
+
+void SimpleDHT11::begin(const pinType &pt) {
+    dht_start_background(dht_one(pt));
+}
+
+bool SimpleDHT11::latest(DHTReading* r) {
+    DHTMulti m;
+
+    return m.latest(0, r);
+}
+
+uint32_t SimpleDHT11::millis() {
+    uint8_t sreg = SREG;
+    uint32_t ticks;
+
+    cli();
+    ticks = dht_ticks;
+    SREG = sreg;
+    return dht_ms(ticks);
+}
@@ -0,0 +1,229 @@
+/*
+ The MIT License (MIT)
+ 
+ Copyright (c) 2016 winlin
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef __SIMPLE_DHT_H
+#define __SIMPLE_DHT_H
+
+#include <avr/io.h>
+#include <util/delay.h>
+#include <string.h>
+
+#define byte uint8_t
+#ifndef LOW
+#define LOW 0
+#endif
+
+#ifndef HIGH
+#define HIGH 1
+#endif
+
+
+/*
+    Simple DHT11
+
+    Simple, Stable and Fast DHT11 library.
+
+    The circuit:
+    * VCC: 5V or 3V
+    * GND: GND
+    * DATA: Digital ping, for example, 2.
+
+    23 Jan 2016 By winlin <winlin@vip.126.com>
+
+    https://github.com/winlinvip/SimpleDHT#usage
+
+    Interrupt decoder (ATtiny25/45/85):
+    The pulses are timed with a free running timer (DHT_TIMER, Timer1
+    by default, 1 tick = 1us up to 8MHz) from the pin change
+    interrupt, not by polling. Both
+    edges are time stamped in the interrupt, so the interrupt latency
+    cancels out and other interrupts only add a few us of jitter.
+    Each bit is shifted straight into the 5 byte result: a high pulse
+    longer than DHT_BIT_THRESHOLD_US is a 1 (26-28us = 0, 70us = 1).
+    The CPU is free while the 40 bits arrive (~4ms).
+
+    Several sensors (DHTMulti):
+    Up to DHT_MAX_CHANNELS DHT11 and DHT22/AM2302 sensors on the same
+    port get one common start signal and answer at the same time. The
+    pin change interrupt reads the port once and decodes every sensor
+    whose pin changed, so N sensors take the time of one reading
+    (~25ms) instead of N. Each extra sensor adds ~2us to the interrupt
+    at 8MHz, the bit threshold leaves ~20us of margin.
+
+    Background acquisition (begin / latest):
+    A state machine in the timer overflow interrupt (every 256us)
+    sends the start signal, captures the bits, checks them and keeps
+    the latest valid reading with its time. It starts a new reading
+    every DHT_INTERVAL_MS (the DHT11 needs at least 1s), or every
+    DHT22_INTERVAL_MS if the port has a DHT22 (at least 2s). latest()
+    returns the cached reading at once, so the main loop never waits
+    for the sensor. Don't call read() after begin().
+
+    Uses PCINT0_vect and the overflow interrupt of its timer, which it
+    sets up (DHT_TIMER 1: Timer1, free with USI_TWI_ASYNC on Timer0;
+    DHT_TIMER 0: Timer0, then not together with USI_TWI_ASYNC on
+    Timer0). The application enables the interrupts (sei()), also for
+    read() and start().
+*/
+
+// Timer for the pulse times and the background state machine (0 or 1)
+#ifndef DHT_TIMER
+#define DHT_TIMER               1
+#endif
+
+// High pulse length that separates a 0 (26-28us) from a 1 (70us)
+#ifndef DHT_BIT_THRESHOLD_US
+#define DHT_BIT_THRESHOLD_US    48
+#endif
+
+// Time allowed for the response and the 40 bits (~4ms)
+#ifndef DHT_TIMEOUT_MS
+#define DHT_TIMEOUT_MS          6
+#endif
+
+// Start signal: DHT11 needs at least 18ms, DHT22 at most 20ms (keep
+// 18-20 when both types share the port)
+#ifndef DHT_START_MS
+#define DHT_START_MS            18
+#endif
+
+// Time between two readings in the background (DHT11 minimum 1s)
+#ifndef DHT_INTERVAL_MS
+#define DHT_INTERVAL_MS         1000
+#endif
+#if DHT_INTERVAL_MS < 1000
+    #error "DHT11: readings must be at least 1s apart"
+#endif
+
+// Time between two readings when the port has a DHT22 (minimum 2s)
+#ifndef DHT22_INTERVAL_MS
+#define DHT22_INTERVAL_MS       (DHT_INTERVAL_MS > 2000 ? DHT_INTERVAL_MS : 2000)
+#endif
+#if DHT22_INTERVAL_MS < 2000
+    #error "DHT22: readings must be at least 2s apart"
+#endif
+
+// Sensors on one port
+#ifndef DHT_MAX_CHANNELS
+#define DHT_MAX_CHANNELS        4
+#endif
+
+#if F_CPU > 2000000UL
+#define DHT_PRESCALE            8
+#else
+#define DHT_PRESCALE            1
+#endif
+#define DHT_TICKS(us)           ((uint8_t) ((F_CPU / DHT_PRESCALE / 1000UL) * (us) / 1000UL))
+
+#if F_CPU / DHT_PRESCALE > 2000000UL
+    #error "DHT11: timer too fast to time an 80us pulse in 8 bits"
+#endif
+
+// Timer overflows (256 ticks) in ms, for the background state machine
+#define DHT_OVF_US              (256UL * DHT_PRESCALE * 1000UL / (F_CPU / 1000UL))
+#define DHT_OVF_TICKS(ms)       ((ms) * 1000UL / DHT_OVF_US + 1)
+
+#define DHT_TYPE_DHT11          0   // 0-50 C, 20-90 %, whole numbers
+#define DHT_TYPE_DHT22          1   // DHT22/AM2302: -40-80 C, 0-100 %, tenths
+
+typedef struct pinType {
+    volatile uint8_t * ddr;
+    volatile uint8_t * pin;
+    volatile uint8_t * port;
+    const uint8_t pos;
+} pinType;
+
+// Sensors on one port, read together
+typedef struct DHTPort {
+    volatile uint8_t * ddr;
+    volatile uint8_t * pin;
+    volatile uint8_t * port;
+    uint8_t count;                      // sensors, up to DHT_MAX_CHANNELS
+    uint8_t pos[DHT_MAX_CHANNELS];      // pin of each sensor
+    uint8_t type[DHT_MAX_CHANNELS];     // DHT_TYPE_...
+} DHTPort;
+
+typedef struct DHTReading {
+    byte temperature;       // whole degrees (DHT11 range, 0 below 0 C)
+    byte humidity;          // whole %
+    int16_t temperature10;  // tenths of a degree, can be negative (DHT22)
+    uint16_t humidity10;    // tenths of a %
+    uint32_t time;          // SimpleDHT11::millis() of the reading
+    uint32_t age;           // ms since the reading (when latest() was called)
+    uint8_t error;          // result of the last attempt, 0 = ok (see finish)
+    uint16_t attempts;      // readings started so far
+} DHTReading;
+
+class DHTMulti {
+public:
+    // read every sensor of the port at once.
+    // @param r one reading per sensor (error set for each).
+    // @return the number of sensors read without error.
+    // @remark the min delay for this method is 1s, 2s with a DHT22.
+    uint8_t read(const DHTPort &p, DHTReading r[]);
+    // start reading the port in the background, every DHT_INTERVAL_MS
+    // (DHT22_INTERVAL_MS if one of the sensors is a DHT22).
+    // @remark p is used by the interrupt, it must stay valid.
+    void begin(const DHTPort &p);
+    // copy of the latest valid reading of sensor ch (error and attempts
+    // of the last attempt are always filled in).
+    // @return false if there was no valid reading yet.
+    bool latest(uint8_t ch, DHTReading* r);
+};
+
+class SimpleDHT11 {
+public:
+    // to read from dht11.
+    // @param pin the DHT11 pin.
+    // @param ptemperature output, NULL to igore.
+    // @param phumidity output, NULL to ignore.
+    // @param pdata output 5 bytes (humidity, humidity decimal,
+    //    temperature, temperature decimal, checksum), NULL to ignore.
+    // @return 0 success; otherwise, error (see finish).
+    // @remark the min delay for this method is 1s.
+    int read(pinType pt, byte* ptemperature, byte* phumidity, byte pdata[5]);
+    // send the start signal (18ms) and let the interrupt decode the
+    // answer in the background.
+    void start(pinType pt);
+    // true while the 40 bits are still coming in.
+    bool busy();
+    // wait for the decoder (at most DHT_TIMEOUT_MS) and check the data.
+    // @return 0 success; 100 no response; 101 no data;
+    //    103 bits missing; 105 checksum error.
+    // @remark 102 and 104 of the polled decoder are not used any more:
+    //    the edge decoder can't tell a missing bit start (102) or end
+    //    (104) apart, both are 103.
+    int finish(byte* ptemperature, byte* phumidity, byte pdata[5]);
+
+    // start reading in the background, every DHT_INTERVAL_MS.
+    void begin(const pinType &pt);
+    // copy of the latest valid reading (error and attempts of the last
+    // attempt are always filled in).
+    // @return false if there was no valid reading yet.
+    bool latest(DHTReading* r);
+    // ms since begin(), counted by the timer overflow.
+    static uint32_t millis();
+};
+
+#endif
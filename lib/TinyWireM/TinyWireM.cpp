@@ -25,10 +25,15 @@ extern "C" {
 
 
 // Initialize Class Variables //////////////////////////////////////////////////
+#if USI_BUF_SIZE
 	uint8_t USI_TWI::USI_Buf[USI_BUF_SIZE];             // holds I2C send and receive data
 	uint8_t USI_TWI::USI_BufIdx = 0;                    // current number of bytes in the send buff
 	uint8_t USI_TWI::USI_LastRead = 0;                  // number of bytes read so far
 	uint8_t USI_TWI::USI_BytesAvail = 0;                // number of bytes requested but not read
+#endif
+#ifdef USI_TWI_ASYNC
+	void (*USI_TWI::USI_Callback)(uint8_t) = 0;         // called when an interrupt driven transfer ends
+#endif
 
 // Constructors ////////////////////////////////////////////////////////////////
 
@@ -41,7 +46,15 @@ void USI_TWI::begin(){ // initialize I2C lib
   USI_TWI_Master_Initialise();          
 }
 
+void USI_TWI::setSpeed(uint8_t speed){ // bus speed for the next transmissions
+  USI_TWI_Set_Speed(speed);
+}
+
+#if USI_BUF_SIZE
 void USI_TWI::beginTransmission(uint8_t slaveAddr){ // setup address & write bit
+#ifdef USI_TWI_ASYNC
+  USI_TWI_Async_Wait();                           // USI_Buf is in use until the transfer ends
+#endif
   USI_BufIdx = 0; 
   USI_Buf[USI_BufIdx] = (slaveAddr<<TWI_ADR_BITS) | USI_SEND; 
 }
@@ -55,7 +68,11 @@ void USI_TWI::send(uint8_t data){ // buffers up data to send
 uint8_t USI_TWI::endTransmission(){ // actually sends the buffer
   bool xferOK = false;
   uint8_t errorCode = 0;
+#ifdef USI_TWI_ASYNC
+  xferOK = USI_TWI_Start_Async(USI_Buf,USI_BufIdx+1,USI_Callback); // returns after the START
+#else
   xferOK = USI_TWI_Start_Read_Write(USI_Buf,USI_BufIdx+1); // core func that does the work
+#endif
   USI_BufIdx = 0;
   if (xferOK) return 0;
   else {                                  // there was an error
@@ -67,12 +84,19 @@ uint8_t USI_TWI::endTransmission(){ // actually sends the buffer
 uint8_t USI_TWI::requestFrom(uint8_t slaveAddr, uint8_t numBytes){ // setup for receiving from slave
   bool xferOK = false;
   uint8_t errorCode = 0;
+#ifdef USI_TWI_ASYNC
+  USI_TWI_Async_Wait();      // USI_Buf is in use until the transfer ends
+#endif
   USI_LastRead = 0;
   USI_BytesAvail = numBytes; // save this off in a global
   numBytes++;                // add extra byte to transmit header
   USI_Buf[0] = (slaveAddr<<TWI_ADR_BITS) | USI_RCVE;   // setup address & Rcve bit
+#ifdef USI_TWI_ASYNC
+  xferOK = USI_TWI_Start_Async(USI_Buf,numBytes,USI_Callback); // data arrives in USI_Buf later
+#else
   xferOK = USI_TWI_Start_Read_Write(USI_Buf,numBytes); // core func that does the work
   // USI_Buf now holds the data read
+#endif
   if (xferOK) return 0;
   else {                                  // there was an error
     errorCode = USI_TWI_Get_State_Info(); // this function returns the error number
@@ -81,14 +105,71 @@ uint8_t USI_TWI::requestFrom(uint8_t slaveAddr, uint8_t numBytes){ // setup for
 }
 
 uint8_t USI_TWI::receive(){ // returns the bytes received one at a time
+#ifdef USI_TWI_ASYNC
+  USI_TWI_Async_Wait();
+#endif
   USI_LastRead++;     // inc first since first uint8_t read is in USI_Buf[1]
   return USI_Buf[USI_LastRead];
 }
 
 uint8_t USI_TWI::available(){ // the bytes available that haven't been read yet
+#ifdef USI_TWI_ASYNC
+  USI_TWI_Async_Wait();
+#endif
   return USI_BytesAvail - (USI_LastRead); 
 }
+#endif
+
+uint8_t USI_TWI::transfer(uint8_t slaveAddr, const USI_TWI_Segment *seg, uint8_t count){ // sends/reads the segments in place
+  if (USI_TWI_Transfer_Segments(slaveAddr, seg, count)) return 0;
+  return USI_TWI_Get_State_Info();      // there was an error
+}
+
+uint8_t USI_TWI::write(uint8_t slaveAddr, const uint8_t *data, uint16_t len){ // sends straight from data
+  USI_TWI_Segment seg[] = { USI_TWI_SEG_TX(data, len) };
+  return transfer(slaveAddr, seg, 1);
+}
+
+uint8_t USI_TWI::write_P(uint8_t slaveAddr, const uint8_t *data, uint16_t len){ // sends straight from flash
+  USI_TWI_Segment seg[] = { USI_TWI_SEG_TX_P(data, len) };
+  return transfer(slaveAddr, seg, 1);
+}
+
+uint8_t USI_TWI::read(uint8_t slaveAddr, uint8_t *data, uint16_t len){ // reads straight into data
+  USI_TWI_Segment seg[] = { USI_TWI_SEG_RX(data, len) };
+  return transfer(slaveAddr, seg, 1);
+}
+
+uint8_t USI_TWI::writeRead(uint8_t slaveAddr, const uint8_t *tx, uint16_t txLen, uint8_t *rx, uint16_t rxLen){ // write, repeated START, read
+  USI_TWI_Segment seg[] = { USI_TWI_SEG_TX(tx, txLen), USI_TWI_SEG_RX(rx, rxLen) };
+  return transfer(slaveAddr, seg, 2);
+}
 
+void USI_TWI::errorCounters(USI_TWI_Error_Counters *counters){ // copies the error counters
+  USI_TWI_Get_Error_Counters(counters);
+}
+
+void USI_TWI::clearErrorCounters(){
+  USI_TWI_Clear_Error_Counters();
+}
+
+uint8_t USI_TWI::busClear(){ // frees a bus held by a stuck slave, 1 = bus free
+  return USI_TWI_Bus_Clear();
+}
+
+#ifdef USI_TWI_ASYNC
+uint8_t USI_TWI::busy(){ // 1 while an interrupt driven transfer is running
+  return USI_TWI_Async_Busy();
+}
+
+uint8_t USI_TWI::wait(){ // waits for the transfer, returns 0 or the error number
+  return USI_TWI_Async_Wait();
+}
+
+void USI_TWI::onComplete(void (*callback)(uint8_t)){ // called from the interrupt with the error number
+  USI_Callback = callback;
+}
+#endif
 
 // Preinstantiate Objects //////////////////////////////////////////////////////
 
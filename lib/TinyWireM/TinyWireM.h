@@ -0,0 +1,115 @@
+/*
+  TinyWireM.h - a wrapper(+) class for TWI/I2C Master library for the ATtiny on Arduino
+  1/21/2011 BroHogan -  brohoganx10 at gmail dot com
+
+  Thanks to 'jkl' for the gcc version of Atmel's USI_TWI_Master code
+  http://www.cs.cmu.edu/~dst/ARTSI/Create/PC%20Comm/
+  I added Atmel's original Device dependant defines section back into USI_TWI_Master.h
+ 
+ 
+ NOTE! - It's very important to use pullups on the SDA & SCL lines! More so than with the Wire lib.
+ 
+ USAGE is modeled after the standard Wire library . . .
+  Put in setup():
+	TinyWireM.begin(){                               // initialize I2C lib
+  Bus speed (optional, can be changed before any transmission):
+	TinyWireM.setSpeed(uint8_t speed){               // USI_TWI_SPEED_STANDARD (100KHz, default) or USI_TWI_SPEED_FAST (400KHz)
+  To Send:
+	TinyWireM.beginTransmission(uint8_t slaveAddr){  // setup slave's address (7 bit address - same as Wire)
+	TinyWireM.send(uint8_t data){                    // buffer up bytes to send - can be called multiple times
+	someByte = TinyWireM.endTransmission(){          // actually send the bytes in the buffer
+	                                                 // returns (optional) 0 = sucess or see USI_TWI_Master.h for error codes
+  To Receive:
+	someByte = TinyWireM.requestFrom(uint8_t slaveAddr, uint8_t numBytes){      // reads 'numBytes' from slave's address
+	                                                 // (usage optional) returns 0= success or see USI_TWI_Master.h for error codes
+	someByte = TinyWireM.receive(){                  // returns the next byte in the received buffer - called multiple times
+	someByte = TinyWireM.available(){                // returns the number of unread bytes in the received buffer
+  Zero-copy transfers (no buffer, no size limit, return 0 = sucess or see USI_TWI_Master.h for error codes):
+	someByte = TinyWireM.write(uint8_t slaveAddr, const uint8_t *data, uint16_t len){   // sends data from RAM
+	someByte = TinyWireM.write_P(uint8_t slaveAddr, const uint8_t *data, uint16_t len){ // sends data from flash
+	someByte = TinyWireM.read(uint8_t slaveAddr, uint8_t *data, uint16_t len){          // reads into data
+	someByte = TinyWireM.writeRead(uint8_t slaveAddr, const uint8_t *tx, uint16_t txLen, uint8_t *rx, uint16_t rxLen){
+	                                                 // writes tx, repeated START, reads into rx (e.g. register reads)
+	someByte = TinyWireM.transfer(uint8_t slaveAddr, const USI_TWI_Segment *seg, uint8_t count){
+	                                                 // any list of segments, see USI_TWI_Transfer_Segments()
+  Error handling (every wait on the bus is bounded by USI_TWI_TIMEOUT_US, a stuck bus is cleared automatically):
+	TinyWireM.errorCounters(USI_TWI_Error_Counters *c){ // copies the NACK/arbitration/timeout counters
+	TinyWireM.clearErrorCounters(){                  // resets them
+	someByte = TinyWireM.busClear(){                 // 9 SCL pulses + STOP, returns 1 if the bus is free
+	Build with -DUSI_BUF_SIZE=0 to drop the buffered calls above and their 16 byte buffer.
+  Interrupt driven (build with -DUSI_TWI_ASYNC, uses Timer0 (or Timer1 with -DUSI_TWI_ASYNC_TIMER=1)
+	 and the USI overflow interrupt, needs sei(); SCL at about the polled speed, see USI_TWI_Master.h):
+	endTransmission() and requestFrom() start the transfer and return at once (0, or an error if START failed)
+	the zero-copy calls stay polled (no async segment transfers), so -DUSI_BUF_SIZE=0 leaves nothing async
+	the other calls wait for the running transfer first, so the usage above does not change
+	someByte = TinyWireM.busy(){                     // returns 1 while a transfer is running
+	someByte = TinyWireM.wait(){                     // waits for the transfer, returns 0 = sucess or error code
+	TinyWireM.onComplete(void (*)(uint8_t)){         // called from the interrupt when a transfer ends (error code)
+
+	TODO:	(by others!)
+	- merge this class with TinyWireS for master & slave support in one library
+
+	This library is free software; you can redistribute it and/or modify it under the
+  terms of the GNU General Public License as published by the Free Software
+  Foundation; either version 2.1 of the License, or any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+  PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef TinyWireM_h
+#define TinyWireM_h
+
+#include <inttypes.h>
+#define USI_SEND         0              // indicates sending to TWI
+#define USI_RCVE         1              // indicates receiving from TWI
+#ifndef USI_BUF_SIZE
+#define USI_BUF_SIZE    16              // bytes in message buffer, 0 = zero-copy calls only
+#endif
+
+#include "USI_TWI_Master.h"
+
+class USI_TWI
+{
+  private:
+#if USI_BUF_SIZE
+	static uint8_t USI_Buf[];           // holds I2C send and receive data
+	static uint8_t USI_BufIdx;          // current number of bytes in the send buff
+	static uint8_t USI_LastRead;        // number of bytes read so far
+	static uint8_t USI_BytesAvail;      // number of bytes requested but not read
+#endif
+#ifdef USI_TWI_ASYNC
+	static void (*USI_Callback)(uint8_t); // called when an interrupt driven transfer ends
+#endif
+	
+  public:
+ 	USI_TWI();
+	void begin();
+	void setSpeed(uint8_t);
+#if USI_BUF_SIZE
+    void beginTransmission(uint8_t);
+    void send(uint8_t);
+    uint8_t endTransmission();
+    uint8_t requestFrom(uint8_t, uint8_t);
+    uint8_t receive(); 
+    uint8_t available(); 
+#endif
+    uint8_t write(uint8_t, const uint8_t *, uint16_t);
+    uint8_t write_P(uint8_t, const uint8_t *, uint16_t);
+    uint8_t read(uint8_t, uint8_t *, uint16_t);
+    uint8_t writeRead(uint8_t, const uint8_t *, uint16_t, uint8_t *, uint16_t);
+    uint8_t transfer(uint8_t, const USI_TWI_Segment *, uint8_t);
+    void errorCounters(USI_TWI_Error_Counters *);
+    void clearErrorCounters();
+    uint8_t busClear();
+#ifdef USI_TWI_ASYNC
+    uint8_t busy();
+    uint8_t wait();
+    void onComplete(void (*)(uint8_t));
+#endif
+};
+
+extern USI_TWI TinyWireM;
+
+#endif
+
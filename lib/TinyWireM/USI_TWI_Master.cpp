@@ -0,0 +1,993 @@
+/*****************************************************************************
+*
+*
+* File              USI_TWI_Master.c compiled with gcc
+* Date              Friday, 10/31/08		Boo!
+* Updated by        jkl
+*
+
+* AppNote           : AVR310 - Using the USI module as a TWI Master
+*
+*		Extensively modified to provide complete I2C driver.
+*	
+*Notes: 
+*		- T4_TWI and T2_TWI delays are computed from F_CPU in cycles, for
+*			Standard (100KHz) or Fast (400KHz) mode set by USI_TWI_Set_Speed.
+*			Refer to the Apps Note.
+*
+*	12/17/08	Added USI_TWI_Start_Memory_Read Routine		-jkl
+*		Note msg buffer will have slave adrs ( with write bit set) and memory adrs;
+*			length should be these two bytes plus the number of bytes to read.
+****************************************************************************/
+#include <avr/interrupt.h>
+//#define F_CPU 1000000UL	      // Sets up the default speed for delay.h
+#include <util/delay.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "USI_TWI_Master.h"
+
+unsigned char USI_TWI_Start_Transceiver_With_Data( unsigned char * , unsigned char );
+unsigned char USI_TWI_Master_Transfer( unsigned char );
+unsigned char USI_TWI_Master_Stop( void );
+unsigned char USI_TWI_Master_Start( void );
+static unsigned char USI_TWI_Fail( unsigned char );
+
+union  USI_TWI_state
+{
+  unsigned char errorState;         // Can reuse the TWI_state for error states since it will not be needed if there is an error.
+  struct
+  {
+    unsigned char addressMode         : 1;
+    unsigned char masterWriteDataMode : 1;
+	unsigned char memReadMode		  : 1;
+    unsigned char unused              : 5;
+  }; 
+}   USI_TWI_state;
+
+static unsigned char USI_TWI_Speed = USI_TWI_SPEED_STANDARD;
+
+// Timeout or data collision seen by USI_TWI_Master_Transfer (0 = none).
+// Kept out of USI_TWI_state, its mode bits are still needed in a transfer.
+static unsigned char USI_TWI_Bus_Fault = 0;
+
+static USI_TWI_Error_Counters USI_TWI_Errors;
+
+// USISR values: clear flags and shift 8 bits (16 clock edges) or 1 bit (2 clock edges)
+#define USI_TWI_USISR_8BIT  ((1<<USISIF)|(1<<USIOIF)|(1<<USIPF)|(1<<USIDC)|(0x0<<USICNT0))
+#define USI_TWI_USISR_1BIT  ((1<<USISIF)|(1<<USIOIF)|(1<<USIPF)|(1<<USIDC)|(0xE<<USICNT0))
+
+// Cycle exact delays. Both constants are compiled in, the speed picks one at run time.
+static inline void USI_TWI_Delay_T2( void )
+{
+  if (USI_TWI_Speed == USI_TWI_SPEED_FAST)
+    __builtin_avr_delay_cycles(T2_TWI_FAST);
+  else
+    __builtin_avr_delay_cycles(T2_TWI_STANDARD);
+}
+
+static inline void USI_TWI_Delay_T4( void )
+{
+  if (USI_TWI_Speed == USI_TWI_SPEED_FAST)
+    __builtin_avr_delay_cycles(T4_TWI_FAST);
+  else
+    __builtin_avr_delay_cycles(T4_TWI_STANDARD);
+}
+
+/*---------------------------------------------------------------
+ Wait for SCL to go high (slave clock stretching), at most
+ USI_TWI_TIMEOUT_US. Returns FALSE on timeout.
+---------------------------------------------------------------*/
+static unsigned char USI_TWI_Wait_SCL_High( void )
+{
+  unsigned int loops = USI_TWI_TIMEOUT_LOOPS;
+
+  while( !(PIN_USI & (1<<PIN_USI_SCL)) )
+  {
+    if ( !--loops )
+    {
+      USI_TWI_Bus_Fault = USI_TWI_BUS_TIMEOUT;
+      return (FALSE);
+    }
+  }
+  return (TRUE);
+}
+
+/*---------------------------------------------------------------
+ USI TWI single master initialization function
+---------------------------------------------------------------*/
+void USI_TWI_Master_Initialise( void )
+{
+  PORT_USI |= (1<<PIN_USI_SDA);           // Enable pullup on SDA, to set high as released state.
+  PORT_USI |= (1<<PIN_USI_SCL);           // Enable pullup on SCL, to set high as released state.
+  
+  DDR_USI  |= (1<<PIN_USI_SCL);           // Enable SCL as output.
+  DDR_USI  |= (1<<PIN_USI_SDA);           // Enable SDA as output.
+  
+  USIDR    =  0xFF;                       // Preload dataregister with "released level" data.
+  USICR    =  (0<<USISIE)|(0<<USIOIE)|                            // Disable Interrupts.
+              (1<<USIWM1)|(0<<USIWM0)|                            // Set USI in Two-wire mode.
+              (1<<USICS1)|(0<<USICS0)|(1<<USICLK)|                // Software stobe as counter clock source
+              (0<<USITC);
+  USISR   =   (1<<USISIF)|(1<<USIOIF)|(1<<USIPF)|(1<<USIDC)|      // Clear flags,
+              (0x0<<USICNT0);                                     // and reset counter.
+}
+
+/*---------------------------------------------------------------
+ Select the bus speed (USI_TWI_SPEED_STANDARD or USI_TWI_SPEED_FAST)
+ for the following transmissions. Can be changed between any two
+ transmissions, e.g. Fast mode for a sensor and Standard mode for
+ a PCF8574 on the same bus.
+---------------------------------------------------------------*/
+void USI_TWI_Set_Speed( unsigned char speed )
+{
+  USI_TWI_Speed = speed;
+}
+
+/*---------------------------------------------------------------
+ Bus clear (I2C specification 3.1.16). A slave that was reset or
+ disturbed in the middle of a byte can hold SDA low forever. Up to 9
+ SCL pulses let it shift out the rest of the byte, then a STOP puts
+ every device back to idle. Called automatically after a timeout, a
+ data collision or a missing START.
+
+ Returns TRUE if the bus is free afterwards.
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Bus_Clear( void )
+{
+  unsigned char i;
+
+  USISR    = (1<<USISIF)|(1<<USIOIF)|(1<<USIPF)|(1<<USIDC); // Clear flags (releases a held SCL).
+  USIDR    = 0xFF;                        // Release SDA.
+  PORT_USI |= (1<<PIN_USI_SDA);
+  DDR_USI  |= (1<<PIN_USI_SDA);
+
+  for ( i = 0; i < 9 && !(PIN_USI & (1<<PIN_USI_SDA)); i++ )
+  {
+    PORT_USI &= ~(1<<PIN_USI_SCL);        // Pull SCL LOW.
+    USI_TWI_Delay_T2();
+    PORT_USI |= (1<<PIN_USI_SCL);         // Release SCL.
+    if ( !USI_TWI_Wait_SCL_High() )       // SCL itself is stuck, pulses can't help.
+      break;
+    USI_TWI_Delay_T4();
+  }
+  USI_TWI_Bus_Fault = 0;                  // The STOP may set it again if SCL is
+                                          // still held: each transfer clears it.
+  PORT_USI &= ~(1<<PIN_USI_SCL);          // SCL low before the STOP.
+  USI_TWI_Delay_T2();
+  return ( USI_TWI_Master_Stop() && (PIN_USI & (1<<PIN_USI_SDA)) );
+}
+
+/*---------------------------------------------------------------
+ Error counters, copied with interrupts disabled so they are
+ consistent even while an interrupt driven transfer runs.
+---------------------------------------------------------------*/
+void USI_TWI_Get_Error_Counters( USI_TWI_Error_Counters *counters )
+{
+  unsigned char sreg = SREG;
+
+  cli();
+  *counters = USI_TWI_Errors;
+  SREG = sreg;
+}
+
+void USI_TWI_Clear_Error_Counters( void )
+{
+  unsigned char sreg = SREG;
+
+  cli();
+  USI_TWI_Errors.noAckAddress = 0;
+  USI_TWI_Errors.noAckData    = 0;
+  USI_TWI_Errors.arbitration  = 0;
+  USI_TWI_Errors.timeout      = 0;
+  SREG = sreg;
+}
+
+static void USI_TWI_Count_Error( unsigned char error )
+{
+  switch (error)
+  {
+    case USI_TWI_NO_ACK_ON_ADDRESS: USI_TWI_Errors.noAckAddress++; break;
+    case USI_TWI_NO_ACK_ON_DATA:    USI_TWI_Errors.noAckData++;    break;
+    case USI_TWI_BUS_TIMEOUT:       USI_TWI_Errors.timeout++;      break;
+    default:                        USI_TWI_Errors.arbitration++;  break;
+  }
+}
+
+/*---------------------------------------------------------------
+ Common end of a failed transfer: count the error and leave the bus
+ free, with a STOP or, if the bus may be stuck, a bus clear.
+ A timeout or collision seen during the transfer wins over the NACK
+ it caused. Always returns FALSE.
+---------------------------------------------------------------*/
+static unsigned char USI_TWI_Fail( unsigned char error )
+{
+  if ( USI_TWI_Bus_Fault )
+    error = USI_TWI_Bus_Fault;
+  USI_TWI_Bus_Fault = 0;
+  USI_TWI_Count_Error( error );
+
+  if ( error == USI_TWI_BUS_TIMEOUT || error == USI_TWI_UE_DATA_COL || error == USI_TWI_MISSING_START_CON )
+    USI_TWI_Bus_Clear();
+  else if ( error != USI_TWI_MISSING_STOP_CON )
+    USI_TWI_Master_Stop();
+
+  USI_TWI_state.errorState = error;
+  return (FALSE);
+}
+
+/*---------------------------------------------------------------
+Use this function to get hold of the error message from the last transmission
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Get_State_Info( void )
+{
+  return ( USI_TWI_state.errorState );                            // Return error state.
+}
+/*---------------------------------------------------------------
+ USI Random (memory) Read function. This function sets up for call
+ to USI_TWI_Start_Transceiver_With_Data which does the work.
+ Doesn't matter if read/write bit is set or cleared, it'll be set
+ correctly in this function.
+ 
+ The msgSize is passed to USI_TWI_Start_Transceiver_With_Data.
+ 
+ Success or error code is returned. Error codes are defined in 
+ USI_TWI_Master.h
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Start_Random_Read( unsigned char *msg, unsigned char msgSize)
+{
+  *(msg) &= ~(TRUE<<TWI_READ_BIT);		// clear the read bit if it's set
+  USI_TWI_state.errorState = 0;
+  USI_TWI_state.memReadMode = TRUE;
+  
+  return (USI_TWI_Start_Transceiver_With_Data( msg, msgSize));
+}
+/*---------------------------------------------------------------
+ USI Normal Read / Write Function
+ Transmit and receive function. LSB of first byte in buffer 
+ indicates if a read or write cycles is performed. If set a read
+ operation is performed.
+
+ Function generates (Repeated) Start Condition, sends address and
+ R/W, Reads/Writes Data, and verifies/sends ACK.
+ 
+ Success or error code is returned. Error codes are defined in 
+ USI_TWI_Master.h
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Start_Read_Write( unsigned char *msg, unsigned char msgSize)
+{
+    
+	USI_TWI_state.errorState = 0;				// Clears all mode bits also
+  
+	return (USI_TWI_Start_Transceiver_With_Data( msg, msgSize));
+	
+}
+/*---------------------------------------------------------------
+ USI Transmit and receive function. LSB of first byte in buffer 
+ indicates if a read or write cycles is performed. If set a read
+ operation is performed.
+
+ Function generates (Repeated) Start Condition, sends address and
+ R/W, Reads/Writes Data, and verifies/sends ACK.
+ 
+ This function also handles Random Read function if the memReadMode
+ bit is set. In that case, the function will:
+ The address in memory will be the second
+ byte and is written *without* sending a STOP. 
+ Then the Read bit is set (lsb of first byte), the byte count is 
+ adjusted (if needed), and the function function starts over by sending
+ the slave address again and reading the data.
+ 
+ Success or error code is returned. Error codes are defined in 
+ USI_TWI_Master.h
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Start_Transceiver_With_Data( unsigned char *msg, unsigned char msgSize)
+{
+  unsigned char const tempUSISR_8bit = (1<<USISIF)|(1<<USIOIF)|(1<<USIPF)|(1<<USIDC)|      // Prepare register value to: Clear flags, and
+                                 (0x0<<USICNT0);                                     // set USI to shift 8 bits i.e. count 16 clock edges.
+  unsigned char const tempUSISR_1bit = (1<<USISIF)|(1<<USIOIF)|(1<<USIPF)|(1<<USIDC)|      // Prepare register value to: Clear flags, and
+                                 (0xE<<USICNT0); 									// set USI to shift 1 bit i.e. count 2 clock edges.
+	unsigned char *savedMsg;
+	unsigned char savedMsgSize; 
+
+//This clear must be done before calling this function so that memReadMode can be specified.
+//  USI_TWI_state.errorState = 0;				// Clears all mode bits also
+
+#ifdef USI_TWI_ASYNC
+  USI_TWI_Async_Wait();                             // Don't interrupt an interrupt driven transfer.
+#endif
+  USI_TWI_Bus_Fault = 0;                            // A bus clear may have left one behind.
+
+  USI_TWI_state.addressMode = TRUE;			// Always true for first byte
+
+#ifdef PARAM_VERIFICATION
+  if(msg > (unsigned char*)RAMEND)                 // Test if address is outside SRAM space
+  {
+    USI_TWI_state.errorState = USI_TWI_DATA_OUT_OF_BOUND;
+    return (FALSE);
+  }
+  if(msgSize <= 1)                                 // Test if the transmission buffer is empty
+  {
+    USI_TWI_state.errorState = USI_TWI_NO_DATA;
+    return (FALSE);
+  }
+#endif
+
+#ifdef NOISE_TESTING                                // Test if any unexpected conditions have arrived prior to this execution.
+  if( USISR & (1<<USISIF) )
+  {
+    USI_TWI_state.errorState = USI_TWI_UE_START_CON;
+    return (FALSE);
+  }
+  if( USISR & (1<<USIPF) )
+  {
+    USI_TWI_state.errorState = USI_TWI_UE_STOP_CON;
+    return (FALSE);
+  }
+  if( USISR & (1<<USIDC) )
+  {
+    USI_TWI_state.errorState = USI_TWI_UE_DATA_COL;
+    return (FALSE);
+  }
+#endif
+
+  if ( !(*msg & (1<<TWI_READ_BIT)) )                // The LSB in the address byte determines if is a masterRead or masterWrite operation.
+  {
+    USI_TWI_state.masterWriteDataMode = TRUE;
+  }
+
+//	if (USI_TWI_state.memReadMode)
+//	{
+		savedMsg = msg;
+		savedMsgSize = msgSize;
+//	}
+
+	if ( !USI_TWI_Master_Start( ))
+  {
+	return USI_TWI_Fail( USI_TWI_state.errorState ); // Send a START condition on the TWI bus.
+  }
+
+/*Write address and Read/Write data */
+  do
+  {
+    /* If masterWrite cycle (or inital address tranmission)*/
+    if (USI_TWI_state.addressMode || USI_TWI_state.masterWriteDataMode)
+    {
+      /* Write a byte */
+      PORT_USI &= ~(1<<PIN_USI_SCL);                // Pull SCL LOW.
+      USIDR     = *(msg++);                        // Setup data.
+      USI_TWI_Master_Transfer( tempUSISR_8bit );    // Send 8 bits on bus.
+      
+      /* Clock and verify (N)ACK from slave */
+      DDR_USI  &= ~(1<<PIN_USI_SDA);                // Enable SDA as input.
+      if( USI_TWI_Master_Transfer( tempUSISR_1bit ) & (1<<TWI_NACK_BIT) ) 
+      {
+        if ( USI_TWI_state.addressMode )
+          return USI_TWI_Fail( USI_TWI_NO_ACK_ON_ADDRESS );
+        else
+          return USI_TWI_Fail( USI_TWI_NO_ACK_ON_DATA );
+      }
+	  
+	  if ((!USI_TWI_state.addressMode) && USI_TWI_state.memReadMode)// means memory start address has been written
+	  {
+		msg = savedMsg;					// start at slave address again
+		*(msg) |= (TRUE<<TWI_READ_BIT);  // set the Read Bit on Slave address
+		USI_TWI_state.errorState = 0;
+		USI_TWI_state.addressMode = TRUE;	// Now set up for the Read cycle
+		msgSize = savedMsgSize;				// Set byte count correctly
+		// NOte that the length should be Slave adrs byte + # bytes to read + 1 (gets decremented below)
+		if ( !USI_TWI_Master_Start( ))
+		{
+			return USI_TWI_Fail( USI_TWI_BAD_MEM_READ ); // Send a START condition on the TWI bus.
+		}
+	  }
+	  else
+	  {
+		USI_TWI_state.addressMode = FALSE;            // Only perform address transmission once.
+	  }
+    }
+    /* Else masterRead cycle*/
+    else
+    {
+      /* Read a data byte */
+      DDR_USI   &= ~(1<<PIN_USI_SDA);               // Enable SDA as input.
+      *(msg++)  = USI_TWI_Master_Transfer( tempUSISR_8bit );
+
+      /* Prepare to generate ACK (or NACK in case of End Of Transmission) */
+      if( msgSize == 1)                            // If transmission of last byte was performed.
+      {
+        USIDR = 0xFF;                              // Load NACK to confirm End Of Transmission.
+      }
+      else
+      {
+        USIDR = 0x00;                              // Load ACK. Set data register bit 7 (output for SDA) low.
+      }
+      USI_TWI_Master_Transfer( tempUSISR_1bit );   // Generate ACK/NACK.
+      if ( USI_TWI_Bus_Fault )
+        return USI_TWI_Fail( 0 );
+    }
+  }while( --msgSize) ;                             // Until all data sent/received.
+  
+  if (!USI_TWI_Master_Stop())
+  {
+	return USI_TWI_Fail( USI_TWI_state.errorState ); // Send a STOP condition on the TWI bus.
+	}
+
+/* Transmission successfully completed*/
+  return (TRUE);
+}
+
+/*---------------------------------------------------------------
+ Write one byte and clock in the (N)ACK. Returns non zero on NACK.
+---------------------------------------------------------------*/
+static unsigned char USI_TWI_Master_Write_Byte( unsigned char data )
+{
+  PORT_USI &= ~(1<<PIN_USI_SCL);                  // Pull SCL LOW.
+  USIDR     = data;                               // Setup data.
+  USI_TWI_Master_Transfer( USI_TWI_USISR_8BIT );  // Send 8 bits on bus.
+  DDR_USI  &= ~(1<<PIN_USI_SDA);                  // Enable SDA as input.
+  return ( USI_TWI_Master_Transfer( USI_TWI_USISR_1BIT ) & (1<<TWI_NACK_BIT) );
+}
+
+/*---------------------------------------------------------------
+ Read one byte and send ACK, or NACK after the last byte.
+---------------------------------------------------------------*/
+static unsigned char USI_TWI_Master_Read_Byte( unsigned char last )
+{
+  unsigned char data;
+
+  DDR_USI &= ~(1<<PIN_USI_SDA);                   // Enable SDA as input.
+  data  = USI_TWI_Master_Transfer( USI_TWI_USISR_8BIT );
+  USIDR = last ? 0xFF : 0x00;                     // Load NACK or ACK.
+  USI_TWI_Master_Transfer( USI_TWI_USISR_1BIT );  // Generate ACK/NACK.
+  return data;
+}
+
+/*---------------------------------------------------------------
+ USI scatter/gather transfer. The bytes go straight from/to the
+ caller's segments, without a message buffer or a size limit.
+
+ Segments are handled in order. Consecutive write segments are sent
+ as one stream, consecutive read segments are read as one stream.
+ A (repeated) START with the address and R/W bit is sent before the
+ first segment and at each change of direction, so a register
+ pointer write followed by a block read is one transaction. The last
+ byte of each read stream gets a NACK. Empty segments are skipped,
+ with no segments at all only the address is sent (device probe).
+
+ address is the 7 bit slave address (not shifted).
+
+ Success or error code is returned. Error codes are defined in 
+ USI_TWI_Master.h
+
+ Polled even when built with USI_TWI_ASYNC (see USI_TWI_Master.h).
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Transfer_Segments( unsigned char address, const USI_TWI_Segment *seg, unsigned char segCount )
+{
+  unsigned char direction = 0xFF;                 // No START sent yet.
+  unsigned char *data;
+  unsigned int size;
+  unsigned char i;
+
+#ifdef USI_TWI_ASYNC
+  USI_TWI_Async_Wait();                           // Don't interrupt an interrupt driven transfer.
+#endif
+  USI_TWI_state.errorState = 0;
+  USI_TWI_Bus_Fault = 0;
+
+  for ( ; ; seg++, segCount-- )
+  {
+    if ( segCount && !seg->size ) continue;       // Skip empty segments.
+
+    /* (Repeated) START and address at the beginning and at each change of direction */
+    if ( direction == 0xFF || (segCount && (seg->flags & USI_TWI_SEG_READ) != direction) )
+    {
+      direction = segCount ? (seg->flags & USI_TWI_SEG_READ) : 0;
+      if ( !USI_TWI_Master_Start( ))
+        return USI_TWI_Fail( USI_TWI_state.errorState );
+      if ( USI_TWI_Master_Write_Byte( (address<<TWI_ADR_BITS) | (direction<<TWI_READ_BIT) ) )
+        return USI_TWI_Fail( USI_TWI_NO_ACK_ON_ADDRESS );
+    }
+    if ( !segCount ) break;
+
+    data = seg->data;
+    size = seg->size;
+    if ( direction )
+    {
+      /* Read: NACK only on the last byte of the read stream */
+      do
+      {
+        unsigned char last = FALSE;
+        if ( size == 1 )
+        {
+          last = TRUE;
+          for ( i = 1; i < segCount; i++ )
+          {
+            if ( !seg[i].size ) continue;
+            last = !(seg[i].flags & USI_TWI_SEG_READ);
+            break;
+          }
+        }
+        *(data++) = USI_TWI_Master_Read_Byte( last );
+        if ( USI_TWI_Bus_Fault )
+          return USI_TWI_Fail( 0 );
+      }while( --size );
+    }
+    else
+    {
+      do
+      {
+        unsigned char byte = (seg->flags & USI_TWI_SEG_PGM) ? pgm_read_byte( data ) : *data;
+        data++;
+        if ( USI_TWI_Master_Write_Byte( byte ) )
+          return USI_TWI_Fail( USI_TWI_NO_ACK_ON_DATA );
+      }while( --size );
+    }
+  }
+
+  if (!USI_TWI_Master_Stop())
+  {
+    return USI_TWI_Fail( USI_TWI_state.errorState ); // Send a STOP condition on the TWI bus.
+  }
+  return (TRUE);
+}
+
+/*---------------------------------------------------------------
+ Probe: START, address (write), STOP. Returns TRUE if a device ACKs.
+ The NACK is an answer here, not an error, so it isn't counted (bus
+ scans, EEPROM ACK polling). Bus faults are handled as usual.
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Probe( unsigned char address )
+{
+  unsigned char nack;
+
+#ifdef USI_TWI_ASYNC
+  USI_TWI_Async_Wait();                           // Don't interrupt an interrupt driven transfer.
+#endif
+  USI_TWI_state.errorState = 0;
+  USI_TWI_Bus_Fault = 0;
+
+  if ( !USI_TWI_Master_Start( ))
+    return USI_TWI_Fail( USI_TWI_state.errorState );
+  nack = USI_TWI_Master_Write_Byte( (address<<TWI_ADR_BITS) | (0<<TWI_READ_BIT) );
+  if ( USI_TWI_Bus_Fault )
+    return USI_TWI_Fail( 0 );
+  if (!USI_TWI_Master_Stop())
+    return USI_TWI_Fail( USI_TWI_state.errorState );
+  return ( !nack );
+}
+
+/*---------------------------------------------------------------
+ Core function for shifting data in and out from the USI.
+ Data to be sent has to be placed into the USIDR prior to calling
+ this function. Data read, will be return'ed from the function.
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Master_Transfer( unsigned char temp )
+{
+  USISR = temp;                                     // Set USISR according to temp.
+                                                    // Prepare clocking.
+  temp  =  (0<<USISIE)|(0<<USIOIE)|                 // Interrupts disabled
+           (1<<USIWM1)|(0<<USIWM0)|                 // Set USI in Two-wire mode.
+           (1<<USICS1)|(0<<USICS0)|(1<<USICLK)|     // Software clock strobe as source.
+           (1<<USITC);                              // Toggle Clock Port.
+  do
+  { 
+	USI_TWI_Delay_T2();
+    USICR = temp;                          // Generate positve SCL edge.
+    if ( !USI_TWI_Wait_SCL_High() )        // Wait for SCL to go high (bounded).
+      break;
+	USI_TWI_Delay_T4();
+#ifdef SIGNAL_VERIFY
+    if( (DDR_USI & (1<<PIN_USI_SDA)) && (USISR & (1<<USIDC)) ) // SDA differs from what we send:
+    {                                      // another master won the arbitration.
+      USI_TWI_Bus_Fault = USI_TWI_UE_DATA_COL;
+      break;
+    }
+#endif
+    USICR = temp;                          // Generate negative SCL edge.
+  }while( !(USISR & (1<<USIOIF)) );        // Check for transfer complete.
+  
+	USI_TWI_Delay_T2();
+  temp  = USI_TWI_Bus_Fault ? 0xFF : USIDR; // Read out data (a fault reads as NACK).
+  USIDR = 0xFF;                            // Release SDA.
+  DDR_USI |= (1<<PIN_USI_SDA);             // Enable SDA as output.
+
+  return temp;                             // Return the data from the USIDR
+}
+/*---------------------------------------------------------------
+ Function for generating a TWI Start Condition. 
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Master_Start( void )
+{
+/* Release SCL to ensure that (repeated) Start can be performed */
+  PORT_USI |= (1<<PIN_USI_SCL);                     // Release SCL.
+  if ( !USI_TWI_Wait_SCL_High() )                   // Verify that SCL becomes high.
+  {
+    USI_TWI_state.errorState = USI_TWI_BUS_TIMEOUT;
+    return (FALSE);
+  }
+  USI_TWI_Delay_T2();
+
+/* Generate Start Condition */
+  PORT_USI &= ~(1<<PIN_USI_SDA);                    // Force SDA LOW.
+	USI_TWI_Delay_T4();                         
+  PORT_USI &= ~(1<<PIN_USI_SCL);                    // Pull SCL LOW.
+  PORT_USI |= (1<<PIN_USI_SDA);                     // Release SDA.
+
+#ifdef SIGNAL_VERIFY
+  if( !(USISR & (1<<USISIF)) )
+  {
+    USI_TWI_state.errorState = USI_TWI_MISSING_START_CON;  
+    return (FALSE);
+  }
+#endif
+  return (TRUE);
+}
+/*---------------------------------------------------------------
+ Function for generating a TWI Stop Condition. Used to release 
+ the TWI bus.
+---------------------------------------------------------------*/
+unsigned char USI_TWI_Master_Stop( void )
+{
+  PORT_USI &= ~(1<<PIN_USI_SDA);           // Pull SDA low.
+  PORT_USI |= (1<<PIN_USI_SCL);            // Release SCL.
+  if ( !USI_TWI_Wait_SCL_High() )          // Wait for SCL to go high.
+  {
+    USI_TWI_state.errorState = USI_TWI_BUS_TIMEOUT;
+    return (FALSE);
+  }
+	USI_TWI_Delay_T4();
+  PORT_USI |= (1<<PIN_USI_SDA);            // Release SDA.
+	USI_TWI_Delay_T2();
+  
+#ifdef SIGNAL_VERIFY
+  if( !(USISR & (1<<USIPF)) )
+  {
+    USI_TWI_state.errorState = USI_TWI_MISSING_STOP_CON;    
+    return (FALSE);
+  }
+#endif
+
+  return (TRUE);
+}
+
+#ifdef USI_TWI_ASYNC
+/*---------------------------------------------------------------
+ Interrupt driven (asynchronous) transfers
+
+ Same bus sequence as USI_TWI_Start_Transceiver_With_Data, but run
+ by two interrupts so the CPU is free during the SCL low periods:
+  - Timer compare match A (USI_TWI_ASYNC_TIMER): one SCL pulse per
+    bit, the high period is timed in the interrupt (T4) and the low
+    period by the timer (T2 or USI_TWI_ASYNC_LOW_US), which is restarted
+    at each falling edge. Also the STOP condition.
+  - USI counter overflow: after 8 bits or 1 (N)ACK bit, sets up the
+    next byte, (N)ACK or the STOP.
+ The master owns SCL, so if these interrupts are delayed by others,
+ SCL periods only get longer and the bus timing stays valid. The
+ timer waits while the overflow interrupt has not run yet, and while
+ a slave stretches the clock.
+
+ Worst case latency added to other interrupts: the timer interrupt,
+ about T4 plus 40 cycles (~10us at 8MHz in standard mode), plus the
+ callback which runs inside it.
+
+ A slave holding SCL low longer than USI_TWI_TIMEOUT_US ends the
+ transfer with USI_TWI_BUS_TIMEOUT. The bus clear is left to the next
+ USI_TWI_Async_Wait (so also the next transfer), to keep the
+ interrupts short.
+
+ memReadMode (USI_TWI_Start_Random_Read) is not supported here.
+---------------------------------------------------------------*/
+#define USI_TWI_ASYNC_IDLE      0
+#define USI_TWI_ASYNC_TX_BYTE   1   // sending address or data byte
+#define USI_TWI_ASYNC_RX_ACK    2   // reading (N)ACK from slave
+#define USI_TWI_ASYNC_RX_BYTE   3   // reading data byte
+#define USI_TWI_ASYNC_TX_ACK    4   // sending (N)ACK to slave
+#define USI_TWI_ASYNC_STOP_SCL  5   // SDA is low, release SCL
+#define USI_TWI_ASYNC_STOP_SDA  6   // SCL is high, release SDA
+#define USI_TWI_ASYNC_STOP_DONE 7   // check STOP and finish
+
+#define USI_TWI_ASYNC_USICR     ((0<<USISIE)|(1<<USIOIE)|                   /* Overflow interrupt enabled */ \
+                                 (1<<USIWM1)|(0<<USIWM0)|                   /* Two-wire mode. */ \
+                                 (1<<USICS1)|(0<<USICS0)|(1<<USICLK))       /* Software clock strobe as source. */
+
+// Cycles from the compare match to the first SCL edge in the interrupt, at least
+// (interrupt response, vector, register pushes), taken off the low period.
+#define USI_TWI_ASYNC_ENTRY     20
+#define USI_TWI_ASYNC_OCR(cycles) ((cycles) > USI_TWI_ASYNC_ENTRY + 1 ? (cycles) - USI_TWI_ASYNC_ENTRY - 1 : 0)
+
+#if USI_TWI_ASYNC_LOW_US
+  #define USI_TWI_ASYNC_OCR_STANDARD  USI_TWI_ASYNC_OCR(F_CPU / 1000000UL * USI_TWI_ASYNC_LOW_US)
+  #define USI_TWI_ASYNC_OCR_FAST      USI_TWI_ASYNC_OCR_STANDARD
+#else
+  #define USI_TWI_ASYNC_OCR_STANDARD  USI_TWI_ASYNC_OCR(TWI_CYCLES(5000))
+  #define USI_TWI_ASYNC_OCR_FAST      USI_TWI_ASYNC_OCR(TWI_CYCLES(1300))
+#endif
+
+// A tick takes at least OCR + 1 + USI_TWI_ASYNC_ENTRY cycles
+#define USI_TWI_ASYNC_TIMEOUT_TICKS(ocr) (F_CPU / 1000000UL * USI_TWI_TIMEOUT_US / ((ocr) + 1 + USI_TWI_ASYNC_ENTRY) + 1)
+
+// SCL rise time allowed after releasing it, before it counts as stretched (1us, ~4 cycles per loop)
+#define USI_TWI_ASYNC_RISE_LOOPS (TWI_CYCLES(1000) / 4 + 1)
+
+#if USI_TWI_ASYNC_OCR_STANDARD > 255
+    #error "USI_TWI_ASYNC_LOW_US too long for the 8 bit compare at this F_CPU"
+#endif
+#if USI_TWI_ASYNC_TIMEOUT_TICKS(0) > 65535
+    #error "USI_TWI_TIMEOUT_US too long for the async mode at this F_CPU"
+#endif
+
+#if USI_TWI_ASYNC_TIMER == 0
+  #define USI_TWI_ASYNC_vect    TIMER0_COMPA_vect
+  #define USI_TWI_ASYNC_TCNT    TCNT0
+  #define USI_TWI_ASYNC_TIMSK   USI_TWI_TIMSK
+  #define USI_TWI_ASYNC_OCIE    OCIE0A
+
+static inline void USI_TWI_Async_Timer_Start( unsigned char ocr )
+{
+  TCNT0  = 0;
+  OCR0A  = ocr;
+  TCCR0A = (1<<WGM01);                        // CTC
+  TCCR0B = (1<<CS00);                         // F_CPU/1
+}
+
+static inline void USI_TWI_Async_Timer_Stop( void )
+{
+  TCCR0B = 0;
+}
+#elif USI_TWI_ASYNC_TIMER == 1
+  #define USI_TWI_ASYNC_vect    TIMER1_COMPA_vect
+  #define USI_TWI_ASYNC_TCNT    TCNT1
+  #define USI_TWI_ASYNC_OCIE    OCIE1A
+  #ifdef TIMSK1
+    #define USI_TWI_ASYNC_TIMSK TIMSK1
+  #else
+    #define USI_TWI_ASYNC_TIMSK TIMSK
+  #endif
+
+static inline void USI_TWI_Async_Timer_Start( unsigned char ocr )
+{
+  TCNT1  = 0;
+  OCR1A  = ocr;
+#if defined(__AVR_ATtiny25__) | defined(__AVR_ATtiny45__) | defined(__AVR_ATtiny85__)
+  OCR1C  = ocr;                               // 8 bit Timer1: top in OCR1C
+  TCCR1  = (1<<CTC1)|(1<<CS10);               // CTC, F_CPU/1
+#else
+  TCCR1A = 0;
+  TCCR1B = (1<<WGM12)|(1<<CS10);              // CTC (top OCR1A), F_CPU/1
+#endif
+}
+
+static inline void USI_TWI_Async_Timer_Stop( void )
+{
+#if defined(__AVR_ATtiny25__) | defined(__AVR_ATtiny45__) | defined(__AVR_ATtiny85__)
+  TCCR1  = 0;
+#else
+  TCCR1B = 0;
+#endif
+}
+#else
+  #error "USI_TWI_ASYNC_TIMER must be 0 or 1"
+#endif
+
+static volatile unsigned char USI_TWI_Async_Phase = USI_TWI_ASYNC_IDLE;
+static volatile unsigned char USI_TWI_Async_Status = 0;
+static volatile unsigned int USI_TWI_Async_Stretch = 0;   // ticks SCL has been held low by a slave
+static unsigned int USI_TWI_Async_Timeout_Ticks;          // USI_TWI_TIMEOUT_US in ticks at the current speed
+static volatile unsigned char USI_TWI_Async_Clear = FALSE; // bus clear pending after a timeout
+static unsigned char *USI_TWI_Async_Msg;
+static unsigned char USI_TWI_Async_Size;   // bytes left, including the one in progress
+static void (*USI_TWI_Async_Callback)( unsigned char );
+
+unsigned char USI_TWI_Start_Async( unsigned char *msg, unsigned char msgSize, void (*callback)( unsigned char ) )
+{
+  USI_TWI_Async_Wait();                       // only one transfer at a time
+
+  USI_TWI_state.errorState = 0;
+  USI_TWI_Bus_Fault = 0;
+  USI_TWI_state.addressMode = TRUE;
+  if ( !(*msg & (1<<TWI_READ_BIT)) )
+  {
+    USI_TWI_state.masterWriteDataMode = TRUE;
+  }
+  USI_TWI_Async_Msg = msg;
+  USI_TWI_Async_Size = msgSize;
+  USI_TWI_Async_Callback = callback;
+  USI_TWI_Async_Status = 0;
+  USI_TWI_Async_Stretch = 0;
+  USI_TWI_Async_Timeout_Ticks = (USI_TWI_Speed == USI_TWI_SPEED_FAST) ?
+    USI_TWI_ASYNC_TIMEOUT_TICKS(USI_TWI_ASYNC_OCR_FAST) : USI_TWI_ASYNC_TIMEOUT_TICKS(USI_TWI_ASYNC_OCR_STANDARD);
+
+  if ( !USI_TWI_Master_Start( ))              // Send a START condition (a few us, not worth an interrupt)
+  {
+    USI_TWI_Fail( USI_TWI_state.errorState );
+    USI_TWI_Async_Status = USI_TWI_state.errorState;
+    return (FALSE);
+  }
+
+  /* SCL is low, set up the address byte */
+  USIDR = *(USI_TWI_Async_Msg++);
+  USISR = USI_TWI_USISR_8BIT;
+  USI_TWI_Async_Phase = USI_TWI_ASYNC_TX_BYTE;
+  USICR = USI_TWI_ASYNC_USICR;
+
+  /* First compare match after the low period, then one per SCL pulse */
+  USI_TWI_Async_Timer_Start( (USI_TWI_Speed == USI_TWI_SPEED_FAST) ? USI_TWI_ASYNC_OCR_FAST : USI_TWI_ASYNC_OCR_STANDARD );
+  USI_TWI_ASYNC_TIMSK |= (1<<USI_TWI_ASYNC_OCIE);
+  return (TRUE);
+}
+
+unsigned char USI_TWI_Async_Busy( void )
+{
+  return ( USI_TWI_Async_Phase != USI_TWI_ASYNC_IDLE );
+}
+
+unsigned char USI_TWI_Async_Wait( void )
+{
+  while ( USI_TWI_Async_Phase != USI_TWI_ASYNC_IDLE );
+  if ( USI_TWI_Async_Clear )                  // Last transfer timed out
+  {
+    USI_TWI_Async_Clear = FALSE;
+    USI_TWI_Bus_Clear();
+  }
+  return ( USI_TWI_Async_Status );
+}
+
+static void USI_TWI_Async_Begin_Stop( void )
+{
+  USISR = (1<<USIOIF);                        // Clear overflow flag only
+  PORT_USI &= ~(1<<PIN_USI_SDA);              // Pull SDA low (SCL is low).
+  USI_TWI_Async_Phase = USI_TWI_ASYNC_STOP_SCL;
+}
+
+static void USI_TWI_Async_Finish( void );
+
+// SCL held low too long: give up now, clear the bus later.
+static void USI_TWI_Async_Timeout( void )
+{
+  USI_TWI_Async_Status = USI_TWI_BUS_TIMEOUT;
+  USI_TWI_Async_Clear = TRUE;
+  USI_TWI_Async_Finish();
+}
+
+static void USI_TWI_Async_Finish( void )
+{
+  USI_TWI_ASYNC_TIMSK &= ~(1<<USI_TWI_ASYNC_OCIE); // Stop the timer
+  USI_TWI_Async_Timer_Stop();
+  USICR  = (0<<USISIE)|(0<<USIOIE)|           // Back to polled mode (interrupts disabled)
+           (1<<USIWM1)|(0<<USIWM0)|
+           (1<<USICS1)|(0<<USICS0)|(1<<USICLK)|
+           (0<<USITC);
+  USI_TWI_Async_Phase = USI_TWI_ASYNC_IDLE;
+  if (USI_TWI_Async_Status)
+    USI_TWI_Count_Error( USI_TWI_Async_Status );
+  if (USI_TWI_Async_Callback)
+    USI_TWI_Async_Callback( USI_TWI_Async_Status );
+}
+
+ISR(USI_TWI_ASYNC_vect)
+{
+  switch (USI_TWI_Async_Phase)
+  {
+    case USI_TWI_ASYNC_TX_BYTE:
+    case USI_TWI_ASYNC_RX_ACK:
+    case USI_TWI_ASYNC_RX_BYTE:
+    case USI_TWI_ASYNC_TX_ACK:
+      if ( USISR & (1<<USIOIF) ) return;      // Bits done, wait for the overflow interrupt (SCL stays low)
+      if ( !(PORT_USI & (1<<PIN_USI_SCL)) )   // End of the low period
+      {
+        unsigned char n = USI_TWI_ASYNC_RISE_LOOPS;
+        USICR = USI_TWI_ASYNC_USICR | (1<<USITC); // Generate positive SCL edge.
+        while ( !(PIN_USI & (1<<PIN_USI_SCL)) && --n ); // Wait for the rise time
+      }
+      if ( !(PIN_USI & (1<<PIN_USI_SCL)) )    // Slave stretches the clock, look again next tick
+      {
+        if ( ++USI_TWI_Async_Stretch > USI_TWI_Async_Timeout_Ticks )
+          USI_TWI_Async_Timeout();
+        return;
+      }
+      USI_TWI_Async_Stretch = 0;
+      USI_TWI_Delay_T4();                     // SCL high period
+      USICR = USI_TWI_ASYNC_USICR | (1<<USITC); // Generate negative SCL edge.
+      USI_TWI_ASYNC_TCNT = 0;                 // Low period from here
+      break;
+
+    case USI_TWI_ASYNC_STOP_SCL:
+      PORT_USI |= (1<<PIN_USI_SCL);           // Release SCL.
+      USI_TWI_Async_Phase = USI_TWI_ASYNC_STOP_SDA;
+      break;
+
+    case USI_TWI_ASYNC_STOP_SDA:
+      if ( !(PIN_USI & (1<<PIN_USI_SCL)) )    // Wait for SCL to go high.
+      {
+        if ( ++USI_TWI_Async_Stretch > USI_TWI_Async_Timeout_Ticks )
+          USI_TWI_Async_Timeout();
+        return;
+      }
+      USI_TWI_Delay_T4();                     // STOP setup time
+      PORT_USI |= (1<<PIN_USI_SDA);           // Release SDA.
+      USI_TWI_ASYNC_TCNT = 0;                 // Bus free time until STOP_DONE
+      USI_TWI_Async_Phase = USI_TWI_ASYNC_STOP_DONE;
+      break;
+
+    case USI_TWI_ASYNC_STOP_DONE:
+#ifdef SIGNAL_VERIFY
+      if( !USI_TWI_Async_Status && !(USISR & (1<<USIPF)) )
+      {
+        USI_TWI_Async_Status = USI_TWI_MISSING_STOP_CON;
+      }
+#endif
+      USI_TWI_Async_Finish();
+      break;
+  }
+}
+
+ISR(USI_TWI_OVF_vect)
+{
+  switch (USI_TWI_Async_Phase)
+  {
+    case USI_TWI_ASYNC_TX_BYTE:               /* Byte sent, clock in (N)ACK from slave */
+      DDR_USI  &= ~(1<<PIN_USI_SDA);          // Enable SDA as input.
+      USISR = USI_TWI_USISR_1BIT;
+      USI_TWI_Async_Phase = USI_TWI_ASYNC_RX_ACK;
+      break;
+
+    case USI_TWI_ASYNC_RX_ACK:
+    {
+      unsigned char nack = USIDR & (1<<TWI_NACK_BIT);
+      USIDR = 0xFF;                           // Release SDA.
+      DDR_USI |= (1<<PIN_USI_SDA);            // Enable SDA as output.
+      if ( nack )
+      {
+        USI_TWI_Async_Status = USI_TWI_state.addressMode ? USI_TWI_NO_ACK_ON_ADDRESS : USI_TWI_NO_ACK_ON_DATA;
+        USI_TWI_Async_Begin_Stop();
+        break;
+      }
+      USI_TWI_state.addressMode = FALSE;
+      if ( --USI_TWI_Async_Size == 0 )        // Until all data sent.
+      {
+        USI_TWI_Async_Begin_Stop();
+      }
+      else if ( USI_TWI_state.masterWriteDataMode )
+      {
+        USIDR = *(USI_TWI_Async_Msg++);       // Setup data.
+        USISR = USI_TWI_USISR_8BIT;
+        USI_TWI_Async_Phase = USI_TWI_ASYNC_TX_BYTE;
+      }
+      else
+      {
+        DDR_USI &= ~(1<<PIN_USI_SDA);         // Enable SDA as input.
+        USISR = USI_TWI_USISR_8BIT;
+        USI_TWI_Async_Phase = USI_TWI_ASYNC_RX_BYTE;
+      }
+      break;
+    }
+
+    case USI_TWI_ASYNC_RX_BYTE:               /* Byte read, send ACK (or NACK after the last byte) */
+      *(USI_TWI_Async_Msg++) = USIDR;
+      USIDR = ( USI_TWI_Async_Size == 1 ) ? 0xFF : 0x00;
+      DDR_USI |= (1<<PIN_USI_SDA);            // Enable SDA as output.
+      USISR = USI_TWI_USISR_1BIT;
+      USI_TWI_Async_Phase = USI_TWI_ASYNC_TX_ACK;
+      break;
+
+    case USI_TWI_ASYNC_TX_ACK:
+      USIDR = 0xFF;                           // Release SDA.
+      if ( --USI_TWI_Async_Size == 0 )        // Until all data received.
+      {
+        USI_TWI_Async_Begin_Stop();
+      }
+      else
+      {
+        DDR_USI &= ~(1<<PIN_USI_SDA);         // Enable SDA as input.
+        USISR = USI_TWI_USISR_8BIT;
+        USI_TWI_Async_Phase = USI_TWI_ASYNC_RX_BYTE;
+      }
+      break;
+
+    default:
+      USISR = (1<<USIOIF);                    // Not from a transfer, clear the flag
+      break;
+  }
+}
+#endif
@@ -0,0 +1,227 @@
+/*****************************************************************************
+*
+*
+* File              USI_TWI_Master.h compiled with gcc
+* Date              Friday, 10/31/08		Boo!
+* Updated by        jkl
+*
+*
+* Supported devices : All device with USI module can be used.
+*                     The example is written for the ATtiny2313
+*
+* AppNote           : AVR310 - Using the USI module as a TWI Master
+*
+* This is modified to just do I2C communication on ATtiny2313 running at 
+*	1MHz. Fast mode is probably possible, but would need a faster clock
+*	and has not been tested.
+*	Delays are now computed from F_CPU. Fast mode needs F_CPU >= 4MHz to
+*	actually reach 400KHz.
+*
+*	12/15/08	Added declaration of USI_TWI_Start_Memory_Read	-jkl
+*	10/19/26	Timing computed from F_CPU, added Fast mode (400KHz)
+****************************************************************************/
+
+#ifndef USI_TWI_MASTER_H
+#define USI_TWI_MASTER_H
+
+//********** Defines **********//
+
+// Defines controlling timing limits, in CPU cycles computed from F_CPU.
+// T2 is the SCL low period, T4 the SCL high period. They are also used
+// for the START/STOP setup and hold times, which are never longer.
+//   Standard mode: SCL <= 100KHz, low >4,7us, high >4,0us -> 5,0us + 5,0us
+//   Fast mode:     SCL <= 400KHz, low >1,3us, high >0,6us -> 1,3us + 1,2us
+
+#define TWI_CYCLES(ns)      ((F_CPU / 1000UL * (ns) + 999999UL) / 1000000UL) // rounded up
+
+// Cycles used by the code around each delay (USICR write + SCL check),
+// taken off the delays so the SCL period is not longer than needed.
+#define TWI_OVERHEAD        3
+#define TWI_DELAY(ns)       (TWI_CYCLES(ns) > TWI_OVERHEAD + 1 ? TWI_CYCLES(ns) - TWI_OVERHEAD : 1)
+
+// For use with __builtin_avr_delay_cycles()
+#define T2_TWI_STANDARD     TWI_DELAY(5000)   // >4,7us
+#define T4_TWI_STANDARD     TWI_DELAY(5000)   // >4,0us
+#define T2_TWI_FAST         TWI_DELAY(1300)   // >1,3us
+#define T4_TWI_FAST         TWI_DELAY(1200)   // >0,6us
+
+// Longest time a slave may hold SCL low (clock stretching) before the
+// transfer is given up with USI_TWI_BUS_TIMEOUT and the bus is cleared.
+// Every wait is bounded, so no call can take longer than its normal bus
+// time plus about two timeouts and the 10 SCL periods of a bus clear.
+#ifndef USI_TWI_TIMEOUT_US
+#define USI_TWI_TIMEOUT_US      1000
+#endif
+#define USI_TWI_TIMEOUT_LOOPS   ((F_CPU / 1000000UL * USI_TWI_TIMEOUT_US + 6) / 7) // a poll loop takes ~7 cycles
+
+#if USI_TWI_TIMEOUT_LOOPS > 65535 || USI_TWI_TIMEOUT_LOOPS < 1
+    #error "USI_TWI_TIMEOUT_US out of range for this F_CPU"
+#endif
+
+// Interrupt driven (asynchronous) mode, enabled with -DUSI_TWI_ASYNC.
+// A timer compare interrupt (CTC, F_CPU/1) makes one SCL pulse per bit:
+// it releases SCL, waits the high period T4 like the polled transfer and
+// pulls SCL low again. The timer then runs the low period, the only time
+// the CPU is free, and the USI counter overflow interrupt handles each
+// byte and (N)ACK. So SCL runs at about the polled speed (USI_TWI_Set_Speed),
+// with about 1/3 of the CPU free in standard mode at 8MHz and almost none
+// in fast mode. USI_TWI_ASYNC_LOW_US makes the low period longer to free
+// more CPU, at a lower SCL rate (e.g. 20 -> ~40KHz, ~2/3 free at 8MHz).
+#ifndef USI_TWI_ASYNC_LOW_US
+#define USI_TWI_ASYNC_LOW_US    0       // 0 = T2 of the current speed
+#endif
+
+// Timer for the async mode: 0 = Timer0 (compare A), 1 = Timer1 (compare A),
+// e.g. when Timer0 is used for PWM or by another library.
+#ifndef USI_TWI_ASYNC_TIMER
+#define USI_TWI_ASYNC_TIMER     0
+#endif
+
+// Bus speeds for USI_TWI_Set_Speed
+#define USI_TWI_SPEED_STANDARD  0   // 100KHz, every I2C device supports it (e.g. PCF8574)
+#define USI_TWI_SPEED_FAST      1   // 400KHz
+
+// Defines error code generating
+//#define PARAM_VERIFICATION
+//#define NOISE_TESTING
+#define SIGNAL_VERIFY		// This should probably be on always.
+
+/****************************************************************************
+  Bit and byte definitions
+****************************************************************************/
+#define TWI_READ_BIT  0       // Bit position for R/W bit in "address byte".
+#define TWI_ADR_BITS  1       // Bit position for LSB of the slave address bits in the init byte.
+#define TWI_NACK_BIT  0       // Bit position for (N)ACK bit.
+
+// Note these have been renumbered from the Atmel Apps Note. Most likely errors are now
+//		lowest numbers so they're easily recognized as LED flashes.
+#define USI_TWI_NO_DATA             0x08  // Transmission buffer is empty
+#define USI_TWI_DATA_OUT_OF_BOUND   0x09  // Transmission buffer is outside SRAM space
+#define USI_TWI_UE_START_CON        0x07  // Unexpected Start Condition
+#define USI_TWI_UE_STOP_CON         0x06  // Unexpected Stop Condition
+#define USI_TWI_UE_DATA_COL         0x05  // Unexpected Data Collision (arbitration)
+#define USI_TWI_NO_ACK_ON_DATA      0x02  // The slave did not acknowledge  all data
+#define USI_TWI_NO_ACK_ON_ADDRESS   0x01  // The slave did not acknowledge  the address
+#define USI_TWI_MISSING_START_CON   0x03  // Generated Start Condition not detected on bus
+#define USI_TWI_MISSING_STOP_CON    0x04  // Generated Stop Condition not detected on bus
+#define USI_TWI_BAD_MEM_READ	    0x0A  // Error during external memory read
+#define USI_TWI_BUS_TIMEOUT         0x0B  // A slave held SCL low longer than USI_TWI_TIMEOUT_US
+
+// Device dependant defines ADDED BACK IN FROM ORIGINAL ATMEL .H
+
+#if defined(__AVR_AT90Mega169__) | defined(__AVR_ATmega169__) | \
+    defined(__AVR_AT90Mega165__) | defined(__AVR_ATmega165__) | \
+    defined(__AVR_ATmega325__) | defined(__AVR_ATmega3250__) | \
+    defined(__AVR_ATmega645__) | defined(__AVR_ATmega6450__) | \
+    defined(__AVR_ATmega329__) | defined(__AVR_ATmega3290__) | \
+    defined(__AVR_ATmega649__) | defined(__AVR_ATmega6490__)
+    #define DDR_USI             DDRE
+    #define PORT_USI            PORTE
+    #define PIN_USI             PINE
+    #define PORT_USI_SDA        PORTE5
+    #define PORT_USI_SCL        PORTE4
+    #define PIN_USI_SDA         PINE5
+    #define PIN_USI_SCL         PINE4
+#endif
+
+#if defined(__AVR_ATtiny25__) | defined(__AVR_ATtiny45__) | defined(__AVR_ATtiny85__) | \
+    defined(__AVR_AT90Tiny26__) | defined(__AVR_ATtiny26__)
+    #define DDR_USI             DDRB
+    #define PORT_USI            PORTB
+    #define PIN_USI             PINB
+    #define PORT_USI_SDA        PORTB0
+    #define PORT_USI_SCL        PORTB2
+    #define PIN_USI_SDA         PINB0
+    #define PIN_USI_SCL         PINB2
+#endif
+
+#if defined(__AVR_AT90Tiny2313__) | defined(__AVR_ATtiny2313__)
+    #define DDR_USI             DDRB
+    #define PORT_USI            PORTB
+    #define PIN_USI             PINB
+    #define PORT_USI_SDA        PORTB5
+    #define PORT_USI_SCL        PORTB7
+    #define PIN_USI_SDA         PINB5
+    #define PIN_USI_SCL         PINB7
+#endif
+
+#if defined(__AVR_ATtiny25__) | defined(__AVR_ATtiny45__) | defined(__AVR_ATtiny85__) | \
+    defined(__AVR_ATtiny24__) | defined(__AVR_ATtiny44__) | defined(__AVR_ATtiny84__)
+    #define USI_TWI_OVF_vect    USI_OVF_vect
+#else
+    #define USI_TWI_OVF_vect    USI_OVERFLOW_vect
+#endif
+
+#ifdef TIMSK0
+    #define USI_TWI_TIMSK       TIMSK0
+#else
+    #define USI_TWI_TIMSK       TIMSK
+#endif
+
+/* From the original .h
+// Device dependant defines - These for ATtiny2313. // CHANGED FOR ATtiny85
+
+    #define DDR_USI             DDRB
+    #define PORT_USI            PORTB
+    #define PIN_USI             PINB
+    #define PORT_USI_SDA        PORTB0   // was PORTB5 - N/U
+    #define PORT_USI_SCL        PORTB2   // was PORTB7 - N/U
+    #define PIN_USI_SDA         PINB0    // was PINB5
+    #define PIN_USI_SCL         PINB2    // was PINB7
+*/
+
+// General defines
+#define TRUE  1
+#define FALSE 0
+
+// Segments for USI_TWI_Transfer_Segments
+#define USI_TWI_SEG_WRITE   0x00    // send the bytes from RAM
+#define USI_TWI_SEG_READ    0x01    // read bytes into RAM
+#define USI_TWI_SEG_PGM     0x02    // with USI_TWI_SEG_WRITE: send the bytes from flash (PROGMEM)
+
+typedef struct
+{
+  unsigned char *data;              // cast const or PROGMEM data for writes
+  unsigned int   size;              // bytes, 0 skips the segment
+  unsigned char  flags;             // USI_TWI_SEG_...
+} USI_TWI_Segment;
+
+#define USI_TWI_SEG_TX(p, n)    { (unsigned char *)(p), (n), USI_TWI_SEG_WRITE }
+#define USI_TWI_SEG_TX_P(p, n)  { (unsigned char *)(p), (n), USI_TWI_SEG_WRITE | USI_TWI_SEG_PGM }
+#define USI_TWI_SEG_RX(p, n)    { (unsigned char *)(p), (n), USI_TWI_SEG_READ }
+
+// Error counters, incremented once per failed transfer
+typedef struct
+{
+  unsigned int noAckAddress;        // USI_TWI_NO_ACK_ON_ADDRESS
+  unsigned int noAckData;           // USI_TWI_NO_ACK_ON_DATA
+  unsigned int arbitration;         // lost arbitration, missing/unexpected START or STOP
+  unsigned int timeout;             // USI_TWI_BUS_TIMEOUT
+} USI_TWI_Error_Counters;
+
+//********** Prototypes **********//
+
+void              USI_TWI_Master_Initialise( void );
+void              USI_TWI_Set_Speed( unsigned char );
+unsigned char USI_TWI_Start_Random_Read( unsigned char * , unsigned char );
+unsigned char USI_TWI_Start_Read_Write( unsigned char * , unsigned char );
+unsigned char USI_TWI_Get_State_Info( void );
+// Always polled, also with USI_TWI_ASYNC: it waits for a running interrupt
+// driven transfer, then blocks for the whole transaction. The async mode
+// has no repeated START and no PROGMEM source, so it has no segment variant.
+unsigned char USI_TWI_Transfer_Segments( unsigned char , const USI_TWI_Segment * , unsigned char );
+unsigned char USI_TWI_Probe( unsigned char );
+unsigned char USI_TWI_Bus_Clear( void );
+void              USI_TWI_Get_Error_Counters( USI_TWI_Error_Counters * );
+void              USI_TWI_Clear_Error_Counters( void );
+
+#ifdef USI_TWI_ASYNC
+// Starts a transfer and returns at once (FALSE if the START failed, see
+// USI_TWI_Get_State_Info). msg must stay valid until the transfer is done.
+// The callback (can be NULL) is called from the interrupt with the status.
+unsigned char USI_TWI_Start_Async( unsigned char * , unsigned char , void (*)( unsigned char ) );
+unsigned char USI_TWI_Async_Busy( void );
+unsigned char USI_TWI_Async_Wait( void );   // waits for the transfer, returns its status (0 = success)
+#endif
+
+#endif
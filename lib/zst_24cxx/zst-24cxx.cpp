@@ -0,0 +1,184 @@
+#include "USI_TWI_Master.h"
+#include "zst-i2c-sched.h"
+#include "zst-24cxx.h"
+
+// ACK polls before giving up, ~110us each at 100KHz (the write cycle is 5ms max)
+#define EE24_WAIT_POLLS     500
+
+#define EE24_SEQ_MASK       0x7FFF
+
+static uint8_t ee24_busy = FALSE;   // a page write may still be programming
+
+static uint16_t ee24_log_next;      // slot for the next record
+static uint16_t ee24_log_seq;       // sequence number of the next record
+static uint16_t ee24_log_count;     // records in the log
+
+/*
+ * Waits until the last page write is programmed: the chip does not
+ * ACK its address while it is busy. Returns 0 or a USI_TWI error.
+ */
+uint8_t EE24_Wait(void) {
+    I2C_Job job = { EE24_ADDRESS, I2C_JOB_PROBE, 0, 0, 0, 0 };
+    uint16_t polls;
+    uint8_t err;
+
+    if (!ee24_busy)
+        return 0;
+    for (polls = 0; polls < EE24_WAIT_POLLS; polls++) {
+        err = I2C_Run(&job);
+        if (!err) {
+            ee24_busy = FALSE;
+            return 0;
+        }
+        if (err != USI_TWI_NO_ACK_ON_ADDRESS)   // bus fault, not just busy
+            return err;
+    }
+    return USI_TWI_NO_ACK_ON_ADDRESS;
+}
+
+/*
+ * Sequential read of len bytes from address: one transaction, the
+ * chip increments the address itself. Returns 0 or a USI_TWI error.
+ */
+uint8_t EE24_Read(uint16_t address, uint8_t *data, uint16_t len) {
+    uint8_t addr[2] = { (uint8_t) (address >> 8), (uint8_t) address };
+    USI_TWI_Segment seg[] = { USI_TWI_SEG_TX(addr, 2), USI_TWI_SEG_RX(data, len) };
+    I2C_Job job = { EE24_ADDRESS, 0, 2, seg, 0, 0 };
+    uint8_t err = EE24_Wait();
+
+    if (err)
+        return err;
+    return I2C_Run(&job);
+}
+
+/*
+ * Writes len bytes to address, one transaction per page (a write
+ * that crosses a page boundary would wrap around inside the page).
+ * Returns after sending the last page, its write cycle is left to
+ * the next access. Returns 0 or a USI_TWI error.
+ */
+uint8_t EE24_Write(uint16_t address, const uint8_t *data, uint16_t len) {
+    uint8_t addr[2];
+    USI_TWI_Segment seg[] = { USI_TWI_SEG_TX(addr, 2), USI_TWI_SEG_TX(data, 0) };
+    I2C_Job job = { EE24_ADDRESS, 0, 2, seg, 0, 0 };
+    uint16_t chunk;
+    uint8_t err;
+
+    while (len) {
+        chunk = EE24_PAGE_SIZE - (address % EE24_PAGE_SIZE);  // up to the page end
+        if (chunk > len)
+            chunk = len;
+        addr[0] = address >> 8;
+        addr[1] = address;
+        seg[1].data = (unsigned char *) data;
+        seg[1].size = chunk;
+
+        err = EE24_Wait();
+        if (err)
+            return err;
+        err = I2C_Run(&job);
+        if (err)
+            return err;
+        ee24_busy = TRUE;
+
+        address += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+// Sequence number of a log slot, EE24_LOG_EMPTY if erased or on error
+static uint16_t EE24_LogSeq(uint16_t slot) {
+    uint8_t seq[2];
+    if (EE24_Read(EE24_LOG_START + slot * EE24_RECORD_SIZE, seq, 2))
+        return EE24_LOG_EMPTY;
+    return (seq[0] << 8) | seq[1];
+}
+
+/*
+ * Finds the end of the log. The records from slot 0 up to the latest
+ * have the sequence numbers seq0, seq0+1, ... and every slot after
+ * it is erased or from the previous round, so a binary search finds
+ * the latest record. Returns 0 or a USI_TWI error.
+ */
+uint8_t EE24_LogOpen(void) {
+    uint16_t seq0, seq, lo, hi, mid;
+
+    seq0 = EE24_LogSeq(0);
+    if (seq0 == EE24_LOG_EMPTY) {
+        ee24_log_next = 0;
+        ee24_log_seq = 0;
+        ee24_log_count = 0;
+        return USI_TWI_Get_State_Info();
+    }
+
+    lo = 0;                     // slot lo is in the current round
+    hi = EE24_LOG_RECORDS;      // slot hi is not
+    while (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        seq = EE24_LogSeq(mid);
+        if (seq != EE24_LOG_EMPTY && ((seq - seq0) & EE24_SEQ_MASK) == mid)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    ee24_log_next = (lo + 1) % EE24_LOG_RECORDS;
+    ee24_log_seq = (seq0 + lo + 1) & EE24_SEQ_MASK;
+    if (EE24_LogSeq(ee24_log_next) == EE24_LOG_EMPTY)
+        ee24_log_count = lo + 1;
+    else
+        ee24_log_count = EE24_LOG_RECORDS;  // wrapped, the log is full
+    return USI_TWI_Get_State_Info();
+}
+
+/*
+ * Appends a record of EE24_LOG_DATA bytes (overwrites the oldest
+ * record when the log is full). Returns 0 or a USI_TWI error.
+ */
+uint8_t EE24_LogAppend(const uint8_t *data) {
+    uint8_t record[EE24_RECORD_SIZE];
+    uint8_t i, err;
+
+    record[0] = ee24_log_seq >> 8;
+    record[1] = ee24_log_seq;
+    for (i = 0; i < EE24_LOG_DATA; i++)
+        record[2 + i] = data[i];
+
+    err = EE24_Write(EE24_LOG_START + ee24_log_next * EE24_RECORD_SIZE, record, EE24_RECORD_SIZE);
+    if (err)
+        return err;
+
+    ee24_log_next = (ee24_log_next + 1) % EE24_LOG_RECORDS;
+    ee24_log_seq = (ee24_log_seq + 1) & EE24_SEQ_MASK;
+    if (ee24_log_count < EE24_LOG_RECORDS)
+        ee24_log_count++;
+    return 0;
+}
+
+/*
+ * Reads the latest record. Returns 0, USI_TWI_NO_DATA if the log is
+ * empty, or a USI_TWI error.
+ */
+uint8_t EE24_LogLatest(EE24_Record *record) {
+    uint8_t raw[EE24_RECORD_SIZE];
+    uint16_t slot;
+    uint8_t i, err;
+
+    if (!ee24_log_count)
+        return USI_TWI_NO_DATA;
+    slot = (ee24_log_next + EE24_LOG_RECORDS - 1) % EE24_LOG_RECORDS;
+    err = EE24_Read(EE24_LOG_START + slot * EE24_RECORD_SIZE, raw, EE24_RECORD_SIZE);
+    if (err)
+        return err;
+
+    record->seq = (raw[0] << 8) | raw[1];
+    for (i = 0; i < EE24_LOG_DATA; i++)
+        record->data[i] = raw[2 + i];
+    return 0;
+}
+
+uint16_t EE24_LogCount(void) {
+    return ee24_log_count;
+}
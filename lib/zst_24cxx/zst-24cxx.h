@@ -0,0 +1,68 @@
+#ifndef __ZST_24CXX_LIB__
+#define __ZST_24CXX_LIB__
+
+/* ----------------------------------
+ * 24Cxx I2C EEPROM
+ * ----------------------------------
+ *
+ * For the 16 bit address parts (24C32 to 24C512). The chip is set
+ * in "zst-24cxx-config.h" in the project's include folder:
+ *
+ *     #define EE24_ADDRESS    0x50    // A2..A0 = 0
+ *     #define EE24_SIZE       4096    // 24C32
+ *     #define EE24_PAGE_SIZE  32      // 24C32/64: 32, 24C128/256: 64
+ *     #define EE24_LOG_START  256     // log area: EE24_LOG_START to EE24_SIZE
+ *
+ * EE24_Write splits the data at page boundaries and sends each page
+ * in one transaction. The chip then needs up to 5ms to program the
+ * page. Instead of waiting a fixed 5ms, the next access polls the
+ * chip until it ACKs again (EE24_Wait), so the CPU only waits when
+ * the EEPROM is really still busy.
+ *
+ * EE24_Read reads any length in one transaction (sequential read).
+ *
+ * Log: append-only records of EE24_LOG_DATA bytes with a 15 bit
+ * sequence number, written round-robin in the log area. EE24_LogOpen
+ * finds the latest record with a binary search (12 reads for 4096
+ * records) instead of reading the whole log.
+ *
+ * Every transfer, ACK polls included, is a job of the I2C scheduler
+ * (zst-i2c-sched.h, run at once with I2C_Run), so the EEPROM shares
+ * the bus with the other devices and shows in its statistics. The
+ * project must link zst_i2c_sched and TinyWireM.
+ *
+ * Wear: the chip takes about 1M write cycles per page, and a page
+ * write (even of one 8 byte record) cycles the whole page. A log of
+ * N records rewrites each page EE24_PAGE_SIZE / 8 times per N
+ * appends, so the log lasts about 1M * N / (EE24_PAGE_SIZE / 8)
+ * appends: 120M on a 24C32 (480 records), ~3.8 years at one record
+ * a second, ~230 years at one a minute.
+ */
+
+#include <stdint.h>
+#include "zst-24cxx-config.h"
+
+#define EE24_RECORD_SIZE    8
+#define EE24_LOG_DATA       (EE24_RECORD_SIZE - 2)
+#define EE24_LOG_RECORDS    ((EE24_SIZE - EE24_LOG_START) / EE24_RECORD_SIZE)
+#define EE24_LOG_EMPTY      0xFFFF  // sequence number of an erased record
+
+#if EE24_PAGE_SIZE % EE24_RECORD_SIZE || EE24_LOG_START % EE24_RECORD_SIZE
+    #error "Log records must not cross a page: EE24_LOG_START and EE24_PAGE_SIZE must be multiples of 8"
+#endif
+
+typedef struct {
+    uint16_t seq;                   // 0 to 0x7FFF, EE24_LOG_EMPTY if erased
+    uint8_t data[EE24_LOG_DATA];
+} EE24_Record;
+
+uint8_t EE24_Wait(void);
+uint8_t EE24_Read(uint16_t address, uint8_t *data, uint16_t len);
+uint8_t EE24_Write(uint16_t address, const uint8_t *data, uint16_t len);
+
+uint8_t EE24_LogOpen(void);
+uint8_t EE24_LogAppend(const uint8_t *data);
+uint8_t EE24_LogLatest(EE24_Record *record);
+uint16_t EE24_LogCount(void);
+
+#endif
@@ -0,0 +1,512 @@
+#include <stddef.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "zst-adc.h"
+
+#if ADC_PRESCALE == 2
+    #define ADC_ADPS (_BV(ADPS0))
+#elif ADC_PRESCALE == 4
+    #define ADC_ADPS (_BV(ADPS1))
+#elif ADC_PRESCALE == 8
+    #define ADC_ADPS (_BV(ADPS1) | _BV(ADPS0))
+#elif ADC_PRESCALE == 16
+    #define ADC_ADPS (_BV(ADPS2))
+#elif ADC_PRESCALE == 32
+    #define ADC_ADPS (_BV(ADPS2) | _BV(ADPS0))
+#elif ADC_PRESCALE == 64
+    #define ADC_ADPS (_BV(ADPS2) | _BV(ADPS1))
+#elif ADC_PRESCALE == 128
+    #define ADC_ADPS (_BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0))
+#else
+    #error "ADC_PRESCALE must be 2, 4, 8, 16, 32, 64 or 128"
+#endif
+
+// Sum of up to 4096 10 bit samples
+#if ADC_OVERSAMPLE_BITS > 3
+typedef uint32_t adc_sum_t;
+#else
+typedef uint16_t adc_sum_t;
+#endif
+
+static volatile uint16_t ADC_Result;
+static volatile uint16_t ADC_ResultCount;
+
+#if ADC_CAPTURE_SIZE
+
+#define ADC_BUF_FREE 0                  // can be filled
+#define ADC_BUF_FILL 1                  // being filled by the interrupt
+#define ADC_BUF_FULL 2                  // waiting for ADC_CaptureRelease
+#define ADC_BUF_NONE 0xFF               // no free buffer: the block is dropped
+
+static uint16_t ADC_Buffer[2][ADC_CAPTURE_SIZE];
+static volatile uint8_t ADC_BufState[2];
+static volatile uint16_t ADC_BufSeq[2]; // block number of each full buffer
+static uint8_t ADC_Fill;                // buffer being filled or ADC_BUF_NONE
+static uint16_t ADC_Index;              // next sample in the block
+static uint16_t ADC_Seq;                // number of the block being filled
+static volatile uint16_t ADC_Dropped;
+
+ISR(ADC_vect) {
+    uint16_t sample = ADCW;             // ADCL then ADCH
+    uint8_t b = ADC_Fill;
+
+    TIFR1 = _BV(OCF1B); // clear the trigger flag, or the next compare match starts no conversion
+    ADC_Result = sample;
+    ADC_ResultCount++;
+
+    if (b != ADC_BUF_NONE)
+        ADC_Buffer[b][ADC_Index] = sample;
+    if (++ADC_Index < ADC_CAPTURE_SIZE)
+        return;
+
+    // End of a block: publish it and take the other buffer if it is free
+    ADC_Index = 0;
+    if (b != ADC_BUF_NONE) {
+        ADC_BufSeq[b] = ADC_Seq;
+        ADC_BufState[b] = ADC_BUF_FULL;
+        b ^= 1;
+    } else {
+        ADC_Dropped++;
+        b = ADC_BufState[0] == ADC_BUF_FREE ? 0 : 1;
+    }
+    ADC_Seq++;
+    if (ADC_BufState[b] == ADC_BUF_FREE)
+        ADC_BufState[b] = ADC_BUF_FILL;
+    else
+        b = ADC_BUF_NONE;
+    ADC_Fill = b;
+}
+
+#elif ADC_SCAN_CHANNELS
+
+static const ADC_ScanChannel *ADC_ScanList; // must stay valid while scanning
+static uint8_t ADC_ScanCount;
+static uint8_t ADC_ScanIndex;           // channel being converted
+static uint8_t ADC_ScanSkip;            // conversions still to throw away
+static uint8_t ADC_ScanN;               // conversions in ADC_ScanSum
+static uint16_t ADC_ScanSum;            // up to 64 10 bit samples
+static uint16_t ADC_ScanConversions;    // per scan, 0 when stopped
+static ADC_ScanChannel ADC_ScanOne;     // list of ADC_Init
+static volatile uint16_t ADC_ScanValue[ADC_SCAN_CHANNELS];
+static volatile uint8_t ADC_ScanSeq[ADC_SCAN_CHANNELS]; // +1 after each update
+
+ISR(ADC_vect) {
+    uint16_t sample = ADCW;             // ADCL then ADCH
+    uint8_t i = ADC_ScanIndex;
+    const ADC_ScanChannel *c = &ADC_ScanList[i];
+
+    if (ADC_ScanSkip) {
+        ADC_ScanSkip--;
+        ADCSRA |= _BV(ADSC);
+        return;
+    }
+    ADC_ScanSum += sample;
+    if (++ADC_ScanN == (1 << c->average)) {
+        ADC_ScanValue[i] = ADC_ScanSum >> c->average;
+        ADC_ScanSeq[i]++;
+        ADC_ScanSum = 0;
+        ADC_ScanN = 0;
+
+        // Next channel, wait for it to settle if ADMUX changes
+        if (++i == ADC_ScanCount)
+            i = 0;
+        ADC_ScanIndex = i;
+        if (ADC_ScanList[i].mux != c->mux) {
+            ADMUX = ADC_ScanList[i].mux;
+            ADC_ScanSkip = ADC_ScanList[i].discard;
+        }
+    }
+    ADCSRA |= _BV(ADSC); // next conversion, with the new ADMUX
+}
+
+#elif ADC_CONTROL
+
+#define ADC_CTRL_MAX ((int32_t) ADC_CTRL_OUT_MAX << 8)
+
+static volatile uint16_t ADC_Setpoint;
+static volatile uint16_t ADC_Output;
+static int32_t ADC_Integral;            // in 1/256 of the output
+#if ADC_CTRL_KD
+static uint16_t ADC_Last;               // previous input
+#endif
+static uint8_t ADC_Started;             // the first conversion is longer, not timed
+static volatile uint8_t ADC_DelayMin;   // in ADC_CTRL_TIMER counts
+static volatile uint8_t ADC_DelayMax;
+static volatile uint16_t ADC_IsrMax;
+static volatile uint8_t ADC_Invalid;    // runs not timed
+
+ISR(ADC_vect) {
+    uint8_t start = ADC_CTRL_TIMER;     // counts since the trigger
+    uint8_t late = ADCSRA & _BV(ADSC);  // the next trigger started a conversion: delay wrapped
+#ifdef ADC_CTRL_TIMER_OVF
+    uint8_t pending = ADC_CTRL_TIMER_OVF(); // a wrap not counted yet: start unknown
+#endif
+    uint16_t input = ADCW;              // ADCL then ADCH
+    int16_t error = ADC_Setpoint - input;
+    int32_t integral = ADC_Integral + (int32_t) error * ADC_CTRL_KI;
+    int32_t out = (int32_t) error * ADC_CTRL_KP + integral;
+    uint8_t end;
+    uint16_t length;
+
+    ADC_CTRL_ACK();
+#if ADC_CTRL_KD
+    out -= (int32_t) (int16_t) (input - ADC_Last) * ADC_CTRL_KD; // on the input: no kick on setpoint changes
+    ADC_Last = input;
+#endif
+
+    // Anti-windup: the integral only moves away from a limit the output is stuck at
+    if (out > ADC_CTRL_MAX) {
+        out = ADC_CTRL_MAX;
+        if (error < 0)
+            ADC_Integral = integral;
+    } else if (out < 0) {
+        out = 0;
+        if (error > 0)
+            ADC_Integral = integral;
+    } else {
+        ADC_Integral = integral;
+    }
+    ADC_CTRL_OUTPUT((uint16_t) (out >> 8));
+    ADC_Output = out >> 8;
+    ADC_Result = input;
+    ADC_ResultCount++;
+
+    if (!ADC_Started) {
+        ADC_Started = 1;
+        return;
+    }
+#ifdef ADC_CTRL_TIMER_OVF
+    if (pending)
+        late = 1;
+#endif
+    if (late) {
+        if (ADC_Invalid != 0xFF)
+            ADC_Invalid++;
+        return;
+    }
+    if (start < ADC_DelayMin)
+        ADC_DelayMin = start;
+    if (start > ADC_DelayMax)
+        ADC_DelayMax = start;
+
+    end = ADC_CTRL_TIMER;
+#ifdef ADC_CTRL_TIMER_OVF
+    if (ADC_CTRL_TIMER_OVF()) { // wrapped during the interrupt (nothing clears it meanwhile)
+        end = ADC_CTRL_TIMER;   // read again: surely after the wrap
+        length = 256 + end - start;
+    } else
+#endif
+        length = (uint8_t) (end - start);
+    if (length > ADC_IsrMax)
+        ADC_IsrMax = length;
+}
+
+#else
+
+static adc_sum_t ADC_Sum;
+static uint16_t ADC_Count;              // samples in ADC_Sum
+
+ISR(ADC_vect) {
+    ADC_Sum += ADCW;                    // ADCL then ADCH
+    if (++ADC_Count < ADC_SAMPLES)
+        return;
+    ADC_Result = ADC_Sum >> ADC_OVERSAMPLE_BITS;
+    ADC_ResultCount++;
+    ADC_Sum = 0;
+    ADC_Count = 0;
+}
+
+#endif
+
+// Channel and reference
+static void ADC_Select(const uint8_t channel) {
+    ADMUX = ADC_REF_VCC | channel;
+    if (channel < 8)
+        DIDR0 |= _BV(channel); // Disable digital input on the pin (bit n is ADCn on the ATtiny84/ATmega328)
+}
+
+void ADC_Init(const uint8_t channel) {
+#if ADC_SCAN_CHANNELS
+    // The scan interrupt needs a list: scan this one channel
+    ADC_ScanOne.mux = ADC_REF_VCC | channel;
+    ADC_ScanStart(&ADC_ScanOne, 1);
+#else
+    ADCSRA = 0; // stop, in case it was running
+#if !ADC_CAPTURE_SIZE && !ADC_CONTROL
+    ADC_Sum = 0;
+    ADC_Count = 0;
+#endif
+
+    ADC_Select(channel); // VCC used as analog reference
+    ADCSRB &= ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0)); // free running mode
+
+    // enable, auto trigger (free running), interrupt, and start
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADSC) | ADC_ADPS;
+#endif
+}
+
+void ADC_Stop(void) {
+    ADCSRA &= ~(_BV(ADATE) | _BV(ADIE) | _BV(ADEN));
+#if ADC_CAPTURE_SIZE
+    TCCR1B &= ~(_BV(CS12) | _BV(CS11) | _BV(CS10)); // stop Timer1
+#elif ADC_SCAN_CHANNELS
+    ADC_ScanConversions = 0;
+#endif
+}
+
+uint16_t ADC_Read(void) {
+    uint8_t sreg = SREG;
+    uint16_t value;
+
+    cli();
+    value = ADC_Result;
+    SREG = sreg;
+    return value;
+}
+
+uint16_t ADC_Results(void) {
+    uint8_t sreg = SREG;
+    uint16_t count;
+
+    cli();
+    count = ADC_ResultCount;
+    SREG = sreg;
+    return count;
+}
+
+uint16_t ADC_Wait(void) {
+    uint16_t count = ADC_Results();
+
+    while (ADC_Results() == count)
+        ;
+    return ADC_Read();
+}
+
+#if !ADC_CAPTURE_SIZE && !ADC_SCAN_CHANNELS && !ADC_CONTROL
+
+uint16_t ADC_ReadQuiet(const uint8_t channel) {
+    uint8_t admux = ADMUX;
+    uint8_t running = ADCSRA & _BV(ADATE);
+    uint16_t count, value;
+
+    // Stop free running, single conversions with the interrupt
+    ADCSRA = 0;
+    ADC_Sum = 0;
+    ADC_Count = 0;
+    ADC_Select(channel);
+    ADCSRA = _BV(ADEN) | _BV(ADIE) | ADC_ADPS;
+
+    count = ADC_ResultCount;
+    set_sleep_mode(SLEEP_MODE_ADC);
+    for (;;) {
+        cli();
+        if (ADC_ResultCount != count)
+            break;
+        if (!(ADCSRA & _BV(ADSC))) {
+            // Going to sleep starts a conversion, the ADC interrupt ends it
+            sleep_enable();
+            sei(); // sleep_cpu runs before any interrupt
+            sleep_cpu();
+            sleep_disable();
+        }
+        sei(); // woken by another interrupt: wait for the conversion
+    }
+    value = ADC_Result;
+    sei();
+
+    if (running) {
+        ADCSRA = 0;
+        ADC_Sum = 0;
+        ADC_Count = 0;
+        ADMUX = admux;
+        ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADSC) | ADC_ADPS;
+    }
+    return value;
+}
+
+#endif
+
+#if ADC_CAPTURE_SIZE
+
+uint8_t ADC_CaptureStart(const uint8_t channel, const uint16_t rate) {
+    // Faster triggers are lost while converting, slower overflow OCR1A
+    if (!rate || rate > ADC_CAPTURE_MAX_HZ || F_CPU / 8 / rate > 65536UL)
+        return 0;
+
+    ADCSRA = 0; // stop, in case it was running
+    TCCR1B = 0;
+
+    ADC_BufState[0] = ADC_BUF_FILL;
+    ADC_BufState[1] = ADC_BUF_FREE;
+    ADC_Fill = 0;
+    ADC_Index = 0;
+    ADC_Seq = 0;
+    ADC_Dropped = 0;
+
+    ADC_Select(channel); // VCC used as analog reference
+
+    // Timer1 mode 4 - CTC (TOP is OCR1A) at F_CPU/8, compare B once per period
+    TCCR1A = 0;
+    TCNT1 = 0;
+    OCR1A = F_CPU / 8 / rate - 1;
+    OCR1B = OCR1A;
+    TIFR1 = _BV(OCF1B);
+
+    // Auto trigger on Timer1 compare match B
+    ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0))) | _BV(ADTS2) | _BV(ADTS0);
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | ADC_ADPS;
+    TCCR1B = _BV(WGM12) | _BV(CS11); // start
+    return 1;
+}
+
+uint16_t ADC_CaptureRate(void) {
+    return F_CPU / 8 / (OCR1A + 1UL);
+}
+
+const uint16_t *ADC_CaptureBlock(uint16_t *seq) {
+    uint8_t sreg = SREG;
+    uint8_t b = ADC_BUF_NONE;
+
+    cli();
+    if (ADC_BufState[0] == ADC_BUF_FULL)
+        b = 0;
+    if (ADC_BufState[1] == ADC_BUF_FULL &&
+        (b == ADC_BUF_NONE || (int16_t) (ADC_BufSeq[1] - ADC_BufSeq[0]) < 0))
+        b = 1;
+    if (b != ADC_BUF_NONE && seq)
+        *seq = ADC_BufSeq[b];
+    SREG = sreg;
+    return b == ADC_BUF_NONE ? NULL : ADC_Buffer[b];
+}
+
+void ADC_CaptureRelease(const uint16_t *block) {
+    ADC_BufState[block == ADC_Buffer[0] ? 0 : 1] = ADC_BUF_FREE;
+}
+
+uint16_t ADC_CaptureDropped(void) {
+    uint8_t sreg = SREG;
+    uint16_t count;
+
+    cli();
+    count = ADC_Dropped;
+    SREG = sreg;
+    return count;
+}
+
+#endif
+
+#if ADC_SCAN_CHANNELS
+
+uint8_t ADC_ScanStart(const ADC_ScanChannel *list, uint8_t count) {
+    uint8_t i, prev;
+
+    ADCSRA = 0; // stop, in case it was running
+    ADC_ScanConversions = 0;
+    if (count > ADC_SCAN_CHANNELS)
+        count = ADC_SCAN_CHANNELS;
+    for (i = 0; i < count; i++)
+        if (list[i].average > ADC_SCAN_AVERAGE_MAX)
+            count = 0;
+    if (!count)
+        return 0;
+
+    ADC_ScanList = list;
+    ADC_ScanCount = count;
+    ADC_ScanIndex = 0;
+    ADC_ScanSkip = list[0].discard;
+    ADC_ScanN = 0;
+    ADC_ScanSum = 0;
+    for (i = 0; i < count; i++) {
+        prev = list[i ? i - 1 : count - 1].mux;
+        ADC_ScanConversions += (1 << list[i].average) + (list[i].mux != prev ? list[i].discard : 0);
+        if ((list[i].mux & 0x3F) < 8)
+            DIDR0 |= _BV(list[i].mux & 0x3F); // Disable digital input on the pin
+    }
+
+    // Single conversions, each started by the interrupt
+    ADMUX = list[0].mux;
+    ADCSRA = _BV(ADEN) | _BV(ADIE) | _BV(ADSC) | ADC_ADPS;
+    return 1;
+}
+
+uint16_t ADC_ScanRead(const uint8_t i) {
+    uint8_t seq;
+    uint16_t value;
+
+    do {
+        seq = ADC_ScanSeq[i];
+        value = ADC_ScanValue[i];
+    } while (seq != ADC_ScanSeq[i]); // updated while reading the 2 bytes
+    return value;
+}
+
+uint8_t ADC_ScanUpdates(const uint8_t i) {
+    return ADC_ScanSeq[i];
+}
+
+uint16_t ADC_ScanRate(void) {
+    if (!ADC_ScanConversions)
+        return 0;
+    return ADC_RATE / ADC_ScanConversions;
+}
+
+#endif
+
+#if ADC_CONTROL
+
+void ADC_ControlStart(const uint8_t channel, const uint16_t setpoint) {
+    ADCSRA = 0; // stop, in case it was running
+
+    ADC_Setpoint = setpoint;
+    ADC_Output = 0;
+    ADC_Integral = 0;
+#if ADC_CTRL_KD
+    ADC_Last = 0;
+#endif
+    ADC_Started = 0;
+    ADC_DelayMin = 0xFF;
+    ADC_DelayMax = 0;
+    ADC_IsrMax = 0;
+    ADC_Invalid = 0;
+
+    ADC_Select(channel); // VCC used as analog reference
+
+    // Auto trigger from the timer, which the project runs
+    ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0))) | ADC_CTRL_TRIGGER;
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | ADC_ADPS;
+}
+
+void ADC_ControlSet(const uint16_t setpoint) {
+    uint8_t sreg = SREG;
+
+    cli();
+    ADC_Setpoint = setpoint;
+    SREG = sreg;
+}
+
+uint16_t ADC_ControlOutput(void) {
+    uint8_t sreg = SREG;
+    uint16_t value;
+
+    cli();
+    value = ADC_Output;
+    SREG = sreg;
+    return value;
+}
+
+void ADC_ControlGetTiming(ADC_ControlTiming *timing) {
+    uint8_t sreg = SREG;
+
+    cli();
+    timing->delay_min = ADC_DelayMin == 0xFF ? 0 : ADC_CTRL_TIMER_BASE + ADC_DelayMin * ADC_CTRL_TIMER_DIV;
+    timing->delay_max = ADC_DelayMin == 0xFF ? 0 : ADC_CTRL_TIMER_BASE + ADC_DelayMax * ADC_CTRL_TIMER_DIV;
+    timing->isr_max = ADC_IsrMax * ADC_CTRL_TIMER_DIV;
+    timing->invalid = ADC_Invalid;
+    ADC_DelayMin = 0xFF;
+    ADC_DelayMax = 0;
+    ADC_IsrMax = 0;
+    ADC_Invalid = 0;
+    SREG = sreg;
+}
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef __ZST_ADC_LIB__
+#define __ZST_ADC_LIB__
+
+/* ----------------------------------
+ * INTERRUPT DRIVEN ADC WITH OVERSAMPLING
+ * ----------------------------------
+ *
+ * The ADC runs in free running mode and the ADC interrupt adds up
+ * 4^ADC_OVERSAMPLE_BITS conversions, then shifts the sum right by
+ * ADC_OVERSAMPLE_BITS (decimation). Each extra bit needs 4 times
+ * more samples: 2 bits -> 16 samples -> 12 bit results.
+ *
+ * Oversampling only adds resolution when the input has at least
+ * ~1 LSB of noise (dither). A perfectly steady input gives the same
+ * code every time and the extra bits stay at 0. The noise of a
+ * potentiometer on VCC is usually enough.
+ *
+ * Throughput: a conversion takes 13 ADC clocks (25 for the first).
+ *   conversions/s = F_CPU / ADC_PRESCALE / 13
+ *   results/s     = conversions/s / 4^ADC_OVERSAMPLE_BITS
+ *
+ *   F_CPU  PRESCALE  ADC clock  conv/s  10 bit  11 bit  12 bit  13 bit
+ *   8MHz   64        125kHz     9615    9615    2404    601     150
+ *   8MHz   128       62.5kHz    4808    4808    1202    300     75
+ *   1MHz   8         125kHz     9615    9615    2404    601     150
+ *
+ * The interrupt takes ~60 cycles, so at 8MHz and 9615 conversions/s
+ * it uses ~7% of the CPU.
+ *
+ * Every mode runs on the ADC interrupt, needs sei(): the functions
+ * below never turn the interrupts on (ADC_ReadQuiet excepted, the
+ * sleep needs them).
+ *
+ *  - ADC_Init selects the channel (VCC reference) and starts the ADC
+ *  - ADC_Stop stops the conversions
+ *  - ADC_Read returns the latest result (0 to ADC_MAX)
+ *  - ADC_Results counts the results so far (to see if there is a new one)
+ *  - ADC_Wait waits for the next result and returns it
+ *  - ADC_ReadQuiet makes one result in ADC Noise Reduction sleep
+ *
+ * ADC Noise Reduction sleep (ADC_ReadQuiet):
+ * The CPU and the I/O clock stop during each conversion, so the
+ * timers, PWM outputs and port pins don't switch and add no noise.
+ * Each of the ADC_SAMPLES conversions is started by going to sleep
+ * and ends with the ADC interrupt, which does the same oversampling
+ * as in free running mode. Free running stops meanwhile and starts
+ * again afterwards. The PWM outputs keep their level while the
+ * timers are stopped: 16 conversions take ~1.7ms at 125kHz, so call
+ * it only a few times per second to keep LEDs from flickering.
+ * Other interrupts wake the CPU early; the conversion then ends
+ * with the CPU running. Set ADC_NOISE_TEST in PWM-ADC-LCD-attiny84
+ * to compare the noise of both modes.
+ *
+ * Capture mode (-DADC_CAPTURE_SIZE=n, replaces the oversampling):
+ * Timer1 (CTC, compare B) starts every conversion, so the samples
+ * are taken at an exact rate with no jitter from the code. The
+ * interrupt stores them in two buffers of ADC_CAPTURE_SIZE samples
+ * (ping-pong): while the main loop sends one, the other one fills.
+ * Blocks are numbered; when the main loop is too slow and both
+ * buffers are still in use, the next block is dropped and counted,
+ * and its number is skipped so the receiver can see the gap.
+ * Timer triggered conversions take 13.5 ADC clocks, so at most
+ * F_CPU / ADC_PRESCALE / 13.5 samples/s (9259 at 8MHz / 64).
+ *
+ *  - ADC_CaptureStart starts sampling a channel every 1/rate s, returns
+ *    0 (nothing changed) for a rate of 0, below F_CPU / 8 / 65536
+ *    (16Hz at 8MHz) or above ADC_CAPTURE_MAX_HZ
+ *  - ADC_CaptureRate returns the real rate (F_CPU / 8 / n) in Hz
+ *  - ADC_CaptureBlock returns the oldest full buffer (NULL if none)
+ *  - ADC_CaptureRelease gives the buffer back to the interrupt
+ *  - ADC_CaptureDropped counts the dropped blocks
+ *
+ * Scan mode (-DADC_SCAN_CHANNELS=n, replaces the oversampling):
+ * The interrupt converts a list of up to n channels in turn, each
+ * with its own reference, number of conversions to throw away after
+ * switching to it (settling, e.g. after a reference change) and
+ * number of conversions to average. Conversions are started one by
+ * one from the interrupt, so the new ADMUX applies to the very next
+ * one. The latest value of every channel is kept in a table that is
+ * read without turning the interrupts off: each update increments a
+ * counter and a read is repeated when the counter changed meanwhile.
+ * Every channel is updated once per scan:
+ *   conversions per scan = sum of (discard + 2^average) of each channel
+ *   scans/s               = ~ADC_RATE / conversions per scan
+ * e.g. 4 channels, discard 1, average 4 (16) at 8MHz / 64:
+ *   9615 / 68 = 141 updates/s per channel.
+ * Discards are skipped when a channel has the same ADMUX as the
+ * one before it (e.g. a list of one channel).
+ *
+ *  - ADC_ScanStart starts scanning a list of ADC_ScanChannel, returns
+ *    0 (ADC stopped) for an empty list or an average above 6 (the
+ *    sum of 2^average samples must fit in 16 bits)
+ *  - ADC_ScanRead returns the latest value of a channel (0 to 1023)
+ *  - ADC_ScanUpdates counts the updates of a channel (8 bit)
+ *  - ADC_ScanRate returns the scans/s (0 when stopped)
+ *  - ADC_Init scans just its channel (VCC reference), read it with
+ *    ADC_ScanRead(0)
+ *
+ *     static const ADC_ScanChannel scan[] = {
+ *         {ADC_REF_VCC | 7, 0, 4},              // potentiometer
+ *         {ADC_REF_VCC | ADC_CH_BANDGAP, 8, 2}, // 1.1V: 1125300 / value = VCC in mV
+ *         {ADC_REF_1V1 | ADC_CH_TEMP, 8, 2},    // temperature sensor
+ *     };
+ *     ADC_ScanStart(scan, 3);
+ *
+ * Control mode (-DADC_CONTROL=1, replaces the oversampling):
+ * A fixed rate PI (or PID) loop. A timer starts every conversion
+ * (ADC_CTRL_TRIGGER) so the input is sampled at an exact rate, and
+ * the ADC interrupt computes the new output and writes it at once
+ * (ADC_CTRL_OUTPUT, e.g. an OCR register). No code in the main loop
+ * is involved, so its delays don't change the loop timing.
+ * The project sets it up in "zst-adc-control-config.h":
+ *
+ *     #define ADC_CTRL_KP 128          // gains in 1/256 output per ADC LSB
+ *     #define ADC_CTRL_KI 16           // (KI: per loop run)
+ *     #define ADC_CTRL_KD 0            // 0 = PI
+ *     #define ADC_CTRL_OUT_MAX 1023    // output 0 to ADC_CTRL_OUT_MAX
+ *     #define ADC_CTRL_OUTPUT(v) (OCR1A = (v))
+ *     #define ADC_CTRL_TRIGGER ADC_TRIG_TIMER0_OVF
+ *     #define ADC_CTRL_ACK()           // clears the trigger flag if no interrupt does
+ *     #define ADC_CTRL_HZ (F_CPU / 8 / 256)  // conversion rate
+ *     #define ADC_CTRL_TIMER TCNT0     // 8 bit count since the trigger,
+ *     #define ADC_CTRL_TIMER_DIV 8     // its prescaler
+ *     #define ADC_CTRL_TIMER_BASE 0    // cycles from the trigger to count 0
+ *     #define ADC_CTRL_TIMER_OVF() (TIFR0 & _BV(TOV0)) // its overflow flag
+ *
+ *   error  = setpoint - input
+ *   output = (KP * error + integral - KD * input change) / 256
+ *   integral += KI * error, except while the output is at a limit
+ *   and the error would push it further (anti-windup)
+ *
+ * The gains are constants: with MUL (ATmega) each product is a few
+ * MUL instructions, without (ATtiny) the compiler turns it into
+ * shifts and adds, so gains with few 1 bits are faster there.
+ * Estimated interrupt length, prologue and epilogue included:
+ *   ATmega328 ~150 cycles, ATtiny84 ~250-400 cycles (PI)
+ * (not measured: use ADC_ControlGetTiming on the hardware)
+ *
+ * Timing: the conversion is started by the hardware trigger, so the
+ * sampling instants have no jitter. The output is written after the
+ * conversion (13.5 ADC clocks: 864 cycles at 8MHz / 64) plus the
+ * interrupt latency, which varies with the other interrupts and the
+ * code running with interrupts off. ADC_ControlGetTiming measures
+ * it with ADC_CTRL_TIMER: the shortest and longest delay from the
+ * trigger to the start of the interrupt (longest - shortest = jitter)
+ * and the longest interrupt body, in CPU cycles (+-ADC_CTRL_TIMER_DIV).
+ * A trigger faster than a conversion is ignored while the ADC is
+ * busy, so the conversions run at a fraction of it (ADC_CTRL_HZ is
+ * that rate). The timer then wraps during the conversion: set
+ * ADC_CTRL_TIMER_BASE to the cycles of the whole periods before the
+ * conversion ends.
+ * A run is not timed, only counted as invalid, when its interrupt
+ * starts after the next trigger (ADSC already set again: the delay
+ * wrapped). With ADC_CTRL_TIMER_OVF (optional, the timer overflow
+ * flag, which stays set while the interrupt runs) an interrupt
+ * longer than the timer period is timed up to 2 periods (511 counts);
+ * without it the interrupt must be shorter than one period.
+ * The input is also the ADC_Read/ADC_Wait result (0 to 1023).
+ *
+ *  - ADC_ControlStart starts the loop on a channel
+ *  - ADC_ControlSet changes the setpoint (0 to 1023)
+ *  - ADC_ControlOutput returns the latest output
+ *  - ADC_ControlGetTiming returns the delays and restarts measuring
+ */
+
+#include <avr/io.h>
+
+// ADC clock divider: 2, 4, 8, 16, 32, 64 or 128.
+// The ADC needs a 50-200kHz clock for its full 10 bit accuracy.
+#ifndef ADC_PRESCALE
+#define ADC_PRESCALE 64
+#endif
+
+// Extra bits from oversampling, 0 (none) to 6
+#ifndef ADC_OVERSAMPLE_BITS
+#define ADC_OVERSAMPLE_BITS 2
+#endif
+
+#if ADC_OVERSAMPLE_BITS < 0 || ADC_OVERSAMPLE_BITS > 6
+    #error "ADC_OVERSAMPLE_BITS must be 0 to 6"
+#endif
+
+#if F_CPU / ADC_PRESCALE > 200000UL
+    #error "ADC clock above 200kHz, use a larger ADC_PRESCALE"
+#endif
+
+// Reference voltage, added to the channel in ADMUX
+#if defined(__AVR_ATtiny24__) || defined(__AVR_ATtiny44__) || defined(__AVR_ATtiny84__)
+#define ADC_REF_VCC 0                           // VCC
+#define ADC_REF_EXT _BV(REFS0)                  // AREF pin (PA0)
+#define ADC_REF_1V1 _BV(REFS1)                  // internal 1.1V
+#define ADC_CH_GND 0x20                         // 0V
+#define ADC_CH_BANDGAP 0x21                     // 1.1V bandgap
+#define ADC_CH_TEMP 0x22                        // temperature sensor (ADC8, 1.1V reference)
+#else // ATmega48/88/168/328
+#define ADC_REF_VCC _BV(REFS0)                  // AVCC
+#define ADC_REF_EXT 0                           // AREF pin
+#define ADC_REF_1V1 (_BV(REFS1) | _BV(REFS0))   // internal 1.1V
+#define ADC_CH_GND 0x0F                         // 0V
+#define ADC_CH_BANDGAP 0x0E                     // 1.1V bandgap
+#define ADC_CH_TEMP 0x08                        // temperature sensor (1.1V reference)
+#endif
+
+// Samples per capture buffer, 0 = no capture mode
+#ifndef ADC_CAPTURE_SIZE
+#define ADC_CAPTURE_SIZE 0
+#endif
+
+// Channels in the scan list, 0 = no scan mode
+#ifndef ADC_SCAN_CHANNELS
+#define ADC_SCAN_CHANNELS 0
+#endif
+
+// 1 = control loop mode
+#ifndef ADC_CONTROL
+#define ADC_CONTROL 0
+#endif
+
+#if (ADC_CAPTURE_SIZE != 0) + (ADC_SCAN_CHANNELS != 0) + (ADC_CONTROL != 0) > 1
+    #error "ADC_CAPTURE_SIZE, ADC_SCAN_CHANNELS and ADC_CONTROL can't be used together"
+#endif
+
+// Auto trigger sources (ADTS2:0 in ADCSRB, same on ATtiny84 and ATmega328)
+#define ADC_TRIG_TIMER0_COMPA (_BV(ADTS1) | _BV(ADTS0))
+#define ADC_TRIG_TIMER0_OVF (_BV(ADTS2))
+#define ADC_TRIG_TIMER1_COMPB (_BV(ADTS2) | _BV(ADTS0))
+#define ADC_TRIG_TIMER1_OVF (_BV(ADTS2) | _BV(ADTS1))
+
+#if ADC_CONTROL
+#include "zst-adc-control-config.h"
+
+#ifndef ADC_CTRL_KD
+#define ADC_CTRL_KD 0
+#endif
+
+#ifndef ADC_CTRL_TIMER_BASE
+#define ADC_CTRL_TIMER_BASE 0
+#endif
+
+#if ADC_CTRL_HZ * 27UL > F_CPU / ADC_PRESCALE * 2
+    #error "ADC_CTRL_HZ too high: a conversion takes 13.5 ADC clocks, triggers meanwhile are ignored"
+#endif
+
+typedef struct {
+    uint16_t delay_min;     // trigger to interrupt, CPU cycles
+    uint16_t delay_max;
+    uint16_t isr_max;       // longest interrupt body, CPU cycles
+    uint8_t invalid;        // runs not timed (see above), up to 255
+} ADC_ControlTiming;
+#endif
+
+#define ADC_SAMPLES (1U << (2 * ADC_OVERSAMPLE_BITS))   // conversions per result
+#define ADC_MAX (1023U << ADC_OVERSAMPLE_BITS)          // largest result
+#define ADC_RATE (F_CPU / ADC_PRESCALE / 13)            // conversions/s
+#define ADC_CAPTURE_MAX_HZ (F_CPU / ADC_PRESCALE * 2 / 27) // timer triggered: 13.5 ADC clocks
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void ADC_Init(const uint8_t channel);
+void ADC_Stop(void);
+uint16_t ADC_Read(void);
+uint16_t ADC_Results(void);
+uint16_t ADC_Wait(void);
+#if !ADC_CAPTURE_SIZE && !ADC_SCAN_CHANNELS && !ADC_CONTROL
+uint16_t ADC_ReadQuiet(const uint8_t channel);
+#endif
+
+#if ADC_CAPTURE_SIZE
+uint8_t ADC_CaptureStart(const uint8_t channel, const uint16_t rate);
+uint16_t ADC_CaptureRate(void);
+const uint16_t *ADC_CaptureBlock(uint16_t *seq);
+void ADC_CaptureRelease(const uint16_t *block);
+uint16_t ADC_CaptureDropped(void);
+#endif
+
+#if ADC_SCAN_CHANNELS
+typedef struct {
+    uint8_t mux;        // ADC_REF_... | channel
+    uint8_t discard;    // conversions thrown away after switching to the channel
+    uint8_t average;    // 2^average conversions averaged, 0 to ADC_SCAN_AVERAGE_MAX
+} ADC_ScanChannel;
+
+#define ADC_SCAN_AVERAGE_MAX 6 // 64 10 bit samples in the 16 bit sum
+
+uint8_t ADC_ScanStart(const ADC_ScanChannel *list, uint8_t count);
+uint16_t ADC_ScanRead(const uint8_t i);
+uint8_t ADC_ScanUpdates(const uint8_t i);
+uint16_t ADC_ScanRate(void);
+#endif
+
+#if ADC_CONTROL
+void ADC_ControlStart(const uint8_t channel, const uint16_t setpoint);
+void ADC_ControlSet(const uint16_t setpoint);
+uint16_t ADC_ControlOutput(void);
+void ADC_ControlGetTiming(ADC_ControlTiming *timing);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+#include <avr/interrupt.h>
+#include <string.h>
+#include "zst-bam.h"
+
+#if defined(TIM1_COMPA_vect)
+    #define BAM_vect TIM1_COMPA_vect        // ATtiny24/44/84
+#else
+    #define BAM_vect TIMER1_COMPA_vect
+#endif
+
+#if defined(TIMSK1)
+    #define BAM_TIMSK TIMSK1
+#else
+    #define BAM_TIMSK TIMSK
+#endif
+
+// Port values of each slot, two tables: one used, one being changed
+static uint8_t BAM_Mask[2][BAM_BITS][BAM_PORTS];
+static uint8_t BAM_Active;              // table used by the interrupt
+static volatile uint8_t BAM_Swap;       // take the other table at the next period
+static uint8_t BAM_Slot;                // slot starting at the next interrupt
+
+ISR(BAM_vect) {
+    uint8_t k = BAM_Slot;
+    const uint8_t *m = BAM_Mask[BAM_Active][k];
+    uint16_t top = ((uint16_t) BAM_TICK << k) - 1;
+
+    // Timer1 was just cleared: slot k lasts 2^k ticks from now
+    OCR1A = top;
+    if (TCNT1 > top) // started too late: CTC would count on to 0xFFFF
+        TCNT1 = top - 1; // match on the next count (a TCNT1 write blocks one)
+    BAM_PORT0 = (BAM_PORT0 & ~BAM_PORT0_PINS) | m[0];
+#ifdef BAM_PORT1
+    BAM_PORT1 = (BAM_PORT1 & ~BAM_PORT1_PINS) | m[1];
+#endif
+
+    if (++k == BAM_BITS) {
+        k = 0;
+        if (BAM_Swap) {
+            BAM_Active ^= 1;
+            BAM_Swap = 0;
+        }
+    }
+    BAM_Slot = k;
+}
+
+void BAM_Init(void) {
+    memset(BAM_Mask, 0, sizeof(BAM_Mask));
+    BAM_Active = 0;
+    BAM_Swap = 0;
+    BAM_Slot = 0;
+
+    // Timer1 mode 4 - CTC (TOP is OCR1A), no prescaler
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12);
+    TCNT1 = 0;
+    OCR1A = BAM_TICK - 1;
+    BAM_TIMSK |= _BV(OCIE1A);
+    TCCR1B |= _BV(CS10);
+}
+
+void BAM_Set(const uint8_t channel, const uint16_t duty) {
+    uint8_t port = channel >> 3;
+    uint8_t pin = _BV(channel & 7);
+    uint8_t next, pending, k, sreg = SREG;
+    uint16_t d = duty;
+
+    if (channel >= BAM_CHANNELS)
+        return;
+
+    // Only the flag needs interrupts off: with BAM_Swap clear the
+    // interrupt neither takes nor reads the other table, so it is
+    // filled with interrupts on (a late interrupt would stretch a slot)
+    cli();
+    pending = BAM_Swap;
+    BAM_Swap = 0;
+    next = BAM_Active ^ 1;
+    SREG = sreg;
+
+    if (!pending) // the other table is old: start from the one in use
+        memcpy(BAM_Mask[next], BAM_Mask[BAM_Active], sizeof(BAM_Mask[0]));
+    for (k = 0; k < BAM_BITS; k++, d >>= 1) {
+        if (d & 1)
+            BAM_Mask[next][k][port] |= pin;
+        else
+            BAM_Mask[next][k][port] &= ~pin;
+    }
+
+    BAM_Swap = 1; // single byte: taken at the next period
+}
@@ -0,0 +1,92 @@
+#ifndef __ZST_BAM_LIB__
+#define __ZST_BAM_LIB__
+
+/* ----------------------------------
+ * SOFTWARE PWM WITH BIT ANGLE MODULATION
+ * ----------------------------------
+ *
+ * Dims up to 16 LEDs on any pins of one or two ports. A period is
+ * made of BAM_BITS slots; slot k lasts 2^k ticks and a channel is
+ * on in slot k when bit k of its duty is 1. So a BAM_BITS bit duty
+ * needs only BAM_BITS interrupts per period (Timer1 compare A, CTC),
+ * whatever the number of channels, and each interrupt writes whole
+ * ports with masks prepared beforehand. BAM_Set only recomputes the
+ * masks of its channel, in a second table that the interrupt takes
+ * at the start of the next period (no half updated period). It keeps
+ * interrupts off only to take that table, a few cycles; call it from
+ * the main loop, not from an interrupt.
+ *
+ * Each project has a "zst-bam-config.h" in its include folder:
+ *
+ *     #define BAM_BITS 8              // duty 0 to 2^BAM_BITS - 1
+ *     #define BAM_TICK 256            // shortest slot, in CPU cycles
+ *     #define BAM_PORT0 PORTC         // channels 0-7 = pins 0-7
+ *     #define BAM_PORT0_PINS 0xFF     // pins of the port used
+ *     #define BAM_PORT1 PORTA         // channels 8-15 (optional)
+ *     #define BAM_PORT1_PINS 0x0F
+ *
+ * BAM_TICK must be longer than the longest delay before the BAM
+ * interrupt (another interrupt running, code with interrupts off)
+ * plus the ~20 cycles until it writes OCR1A. A later interrupt finds
+ * Timer1 past the new OCR1A: it then ends the slot at once, so that
+ * slot is too long (a brightness error) but the period goes on.
+ *
+ *   refresh = F_CPU / (BAM_TICK * (2^BAM_BITS - 1))
+ *   CPU     = BAM_BITS * interrupt cycles / (BAM_TICK * (2^BAM_BITS - 1))
+ *
+ *   8MHz, BAM_TICK 128   8 channels (1 port)   16 channels (2 ports)
+ *   8 bit                245Hz, ~1.2%          245Hz, ~1.5%
+ *   10 bit               61Hz (flickers)       61Hz (flickers)
+ *   8 bit, BAM_TICK 64   490Hz, ~2.5%          490Hz, ~3%
+ *   8 bit, BAM_TICK 256  122Hz, ~0.6%          122Hz, ~0.7%
+ * (interrupt ~50 cycles for 1 port, ~60 for 2: estimated, not measured)
+ *
+ * The pins of BAM_PORTx not in BAM_PORTx_PINS can still be used,
+ * but change them with interrupts off: the interrupt rewrites the
+ * port. The pins must be set as outputs by the project.
+ *
+ *  - BAM_Init starts the interrupt with all channels off (needs sei(),
+ *    left to the project)
+ *  - BAM_Set sets the duty of a channel
+ */
+
+#include <avr/io.h>
+#include "zst-bam-config.h"
+
+#ifndef BAM_BITS
+#define BAM_BITS 8
+#endif
+#ifndef BAM_TICK
+#define BAM_TICK 128
+#endif
+#if !defined(BAM_PORT0) || !defined(BAM_PORT0_PINS)
+    #error "BAM_PORT0 and BAM_PORT0_PINS are not defined in zst-bam-config.h"
+#endif
+
+#ifdef BAM_PORT1
+#define BAM_PORTS 2
+#define BAM_CHANNELS 16
+#else
+#define BAM_PORTS 1
+#define BAM_CHANNELS 8
+#endif
+
+#if BAM_BITS < 1 || BAM_BITS > 16 || BAM_TICK * (1UL << (BAM_BITS - 1)) > 65536UL
+    #error "BAM_TICK << (BAM_BITS - 1) must fit in Timer1 (65536)"
+#endif
+
+#define BAM_MAX ((1UL << BAM_BITS) - 1)
+#define BAM_REFRESH_HZ (F_CPU / (BAM_TICK * BAM_MAX))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void BAM_Init(void);
+void BAM_Set(const uint8_t channel, const uint16_t duty);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
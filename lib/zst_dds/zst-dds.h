@@ -0,0 +1,78 @@
+#ifndef __ZST_DDS_LIB__
+#define __ZST_DDS_LIB__
+
+/* ----------------------------------
+ * DIRECT DIGITAL SYNTHESIS ON A PWM OUTPUT
+ * ----------------------------------
+ *
+ * The timer overflow interrupt adds a tuning word to a 24 bit phase
+ * accumulator once per PWM period and loads the compare register
+ * from a 256 entry waveform table in flash (index = top 8 bits of
+ * the phase). The PWM output, low-pass filtered (e.g. 1k + 100nF),
+ * gives the waveform.
+ *
+ *   sample rate   DDS_SAMPLE_HZ = F_CPU / 510 (8 bit phase correct PWM)
+ *                 15686 Hz at 8MHz
+ *   frequency     tuning * DDS_SAMPLE_HZ / 2^24
+ *   resolution    DDS_SAMPLE_HZ / 2^24 = 0.00094 Hz at 8MHz
+ *   highest       DDS_SAMPLE_HZ / 2 = 7843 Hz (2 samples per period);
+ *                 ~2 kHz for a waveform with >= 8 samples per period
+ *
+ * ISR budget: ~85 cycles per sample (estimated: ~45 for saving and
+ * restoring the registers, ~40 for the add and the table read; not
+ * measured) out of the 510 cycles of a PWM period, so ~17% of the
+ * CPU. Writing the compare register is glitch free:
+ * it is double buffered in the PWM modes.
+ *
+ *  - DDS_Init starts the interrupt with a waveform (PWM and sei() by
+ *    the project)
+ *  - DDS_Wave changes the waveform table (256 bytes in PROGMEM)
+ *  - DDS_SetTuning sets the tuning word, see DDS_TUNING(hz)
+ *  - DDS_SetFrequency sets the frequency in 1/100 Hz
+ *
+ * Waveforms: DDS_SINE, DDS_TRIANGLE, DDS_SAW (only the ones used
+ * are linked), or any 256 byte PROGMEM table.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#ifndef DDS_OCR
+#define DDS_OCR OCR0
+#endif
+
+#ifndef DDS_vect
+#define DDS_vect TIMER0_OVF_vect
+#define DDS_TIMSK TIMSK
+#define DDS_TOIE TOIE0
+#endif
+
+// Samples per second: one per PWM period
+#ifndef DDS_SAMPLE_HZ
+#define DDS_SAMPLE_HZ (F_CPU / 510)
+#endif
+
+// Tuning word for a frequency in Hz (constant expressions)
+#define DDS_TUNING(hz) ((uint32_t) ((hz) * 16777216.0 / DDS_SAMPLE_HZ + 0.5))
+
+// DDS_SetFrequency: tuning = (centihertz * DDS_CHZ_K) >> 8, fits 32 bits up to DDS_SAMPLE_HZ / 2
+#define DDS_CHZ_K ((uint32_t) (4294967296.0 / (DDS_SAMPLE_HZ * 100.0) + 0.5))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const uint8_t DDS_SINE[256] PROGMEM;
+extern const uint8_t DDS_TRIANGLE[256] PROGMEM;
+extern const uint8_t DDS_SAW[256] PROGMEM;
+
+void DDS_Init(const uint8_t *table);
+void DDS_Wave(const uint8_t *table);
+void DDS_SetTuning(const uint32_t tuning);
+void DDS_SetFrequency(const uint32_t centihertz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
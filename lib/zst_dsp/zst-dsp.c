@@ -0,0 +1,204 @@
+#include "zst-dsp.h"
+
+#if !defined(__AVR_HAVE_MUL__)
+
+// Shift and add over the bits of the smaller operand
+int32_t DSP_Mul(const int16_t a, const int16_t b) {
+    uint16_t ua = a < 0 ? -a : a;
+    uint16_t ub = b < 0 ? -b : b;
+    uint32_t x, acc = 0;
+
+    if (ua < ub) {
+        x = ub;
+        ub = ua;
+    } else {
+        x = ua;
+    }
+    while (ub) {
+        if (ub & 1)
+            acc += x;
+        x <<= 1;
+        ub >>= 1;
+    }
+    return (a ^ b) < 0 ? -(int32_t) acc : (int32_t) acc;
+}
+
+int16_t DSP_Mul8(const int8_t a, const int8_t b) {
+    uint8_t ua = a < 0 ? -a : a;
+    uint8_t ub = b < 0 ? -b : b;
+    uint16_t x, acc = 0;
+
+    if (ua < ub) {
+        x = ub;
+        ub = ua;
+    } else {
+        x = ua;
+    }
+    while (ub) {
+        if (ub & 1)
+            acc += x;
+        x <<= 1;
+        ub >>= 1;
+    }
+    return (a ^ b) < 0 ? -(int16_t) acc : (int16_t) acc;
+}
+
+#endif
+
+void DSP_AvgInit(DSP_Avg *f, int16_t *buf, const uint8_t bits, const int16_t initial) {
+    uint16_t i, n = 1U << bits;
+
+    for (i = 0; i < n; i++)
+        buf[i] = initial;
+    f->buf = buf;
+    f->sum = (int32_t) initial << bits;
+    f->bits = bits;
+    f->i = 0;
+}
+
+int16_t DSP_AvgPut(DSP_Avg *f, const int16_t x) {
+    uint8_t i = f->i;
+
+    f->sum += (int32_t) x - f->buf[i]; // 30000 - -30000 overflows 16 bits
+    f->buf[i] = x;
+    f->i = (i + 1) & ((1 << f->bits) - 1);
+    if (!f->bits)
+        return x;
+    return (f->sum + (1L << (f->bits - 1))) >> f->bits; // rounded
+}
+
+void DSP_MedianInit(DSP_Median *f, int16_t *buf, const uint8_t n, const int16_t initial) {
+    uint8_t i;
+
+    for (i = 0; i < 2 * n; i++)
+        buf[i] = initial;
+    f->ring = buf;
+    f->sorted = buf + n;
+    f->n = n;
+    f->i = 0;
+}
+
+int16_t DSP_MedianPut(DSP_Median *f, const int16_t x) {
+    int16_t *s = f->sorted;
+    int16_t old = f->ring[f->i];
+    uint8_t j = 0, n = f->n;
+
+    f->ring[f->i] = x;
+    if (++f->i == n)
+        f->i = 0;
+
+    // Replace the oldest sample by the new one and keep the order
+    while (s[j] != old)
+        j++;
+    if (x > old) {
+        while (j + 1 < n && s[j + 1] < x) {
+            s[j] = s[j + 1];
+            j++;
+        }
+    } else {
+        while (j > 0 && s[j - 1] > x) {
+            s[j] = s[j - 1];
+            j--;
+        }
+    }
+    s[j] = x;
+    return s[n >> 1];
+}
+
+void DSP_FirInit(DSP_Fir *f, const int16_t *coef, int16_t *delay, const uint8_t taps) {
+    uint8_t i;
+
+    for (i = 0; i < taps; i++)
+        delay[i] = 0;
+    f->coef = coef;
+    f->delay = delay;
+    f->taps = taps;
+    f->i = 0;
+}
+
+int16_t DSP_FirPut(DSP_Fir *f, const int16_t x) {
+    const int16_t *h = f->coef;
+    uint8_t j = f->i, k;
+    int32_t acc = 0x4000; // rounding
+
+    if (++j == f->taps)
+        j = 0;
+    f->i = j;
+    f->delay[j] = x;
+
+    // h[0] x[n] + h[1] x[n-1] + ..., going back through the delay line
+    for (k = f->taps; k; k--) {
+        acc += DSP_Mul(pgm_read_word(h++), f->delay[j]);
+        j = j ? j - 1 : f->taps - 1;
+    }
+    return DSP_Sat(acc >> 15);
+}
+
+void DSP_FirBlock(DSP_Fir *f, int16_t *data, uint16_t n) {
+    for (; n; n--, data++)
+        *data = DSP_FirPut(f, *data);
+}
+
+void DSP_Fir7Init(DSP_Fir7 *f, const int8_t *coef, int8_t *delay, const uint8_t taps) {
+    uint8_t i;
+
+    for (i = 0; i < taps; i++)
+        delay[i] = 0;
+    f->coef = coef;
+    f->delay = delay;
+    f->taps = taps;
+    f->i = 0;
+}
+
+int8_t DSP_Fir7Put(DSP_Fir7 *f, const int8_t x) {
+    const int8_t *h = f->coef;
+    uint8_t j = f->i, k;
+    int32_t acc = 0x80; // Q15 sum, rounding to Q7
+
+    if (++j == f->taps)
+        j = 0;
+    f->i = j;
+    f->delay[j] = x;
+
+    for (k = f->taps; k; k--) {
+        acc += DSP_MulQ7((int8_t) pgm_read_byte(h++), f->delay[j]);
+        j = j ? j - 1 : f->taps - 1;
+    }
+    acc >>= 8;
+    if (acc > 127)
+        return 127;
+    if (acc < -128)
+        return -128;
+    return acc;
+}
+
+void DSP_BiquadInit(DSP_Biquad *f, const DSP_BiquadCoef *coef, const int16_t initial) {
+    // Settled at the initial value (for a DC gain of 1)
+    f->coef = coef;
+    f->x1 = f->x2 = initial;
+    f->y1 = f->y2 = initial;
+}
+
+int16_t DSP_BiquadPut(DSP_Biquad *f, const int16_t x) {
+    const DSP_BiquadCoef *c = f->coef;
+    int32_t acc = 0x2000; // rounding
+    int16_t y;
+
+    acc += DSP_Mul(pgm_read_word(&c->b0), x);
+    acc += DSP_Mul(pgm_read_word(&c->b1), f->x1);
+    acc += DSP_Mul(pgm_read_word(&c->b2), f->x2);
+    acc -= DSP_Mul(pgm_read_word(&c->a1), f->y1);
+    acc -= DSP_Mul(pgm_read_word(&c->a2), f->y2);
+    y = DSP_Sat(acc >> 14);
+
+    f->x2 = f->x1;
+    f->x1 = x;
+    f->y2 = f->y1;
+    f->y1 = y;
+    return y;
+}
+
+void DSP_BiquadBlock(DSP_Biquad *f, int16_t *data, uint16_t n) {
+    for (; n; n--, data++)
+        *data = DSP_BiquadPut(f, *data);
+}
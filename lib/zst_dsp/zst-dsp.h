@@ -0,0 +1,181 @@
+#ifndef __ZST_DSP_LIB__
+#define __ZST_DSP_LIB__
+
+/* ----------------------------------
+ * FIXED POINT FILTERS
+ * ----------------------------------
+ *
+ * Streaming filters: each call takes one sample and returns the
+ * filtered one (Block calls filter a buffer in place). The state
+ * is a struct and buffers given by the caller (static arrays),
+ * nothing is allocated. Coefficients are tables in flash (PROGMEM).
+ *
+ * Formats: Q15 is an int16_t / 32768 (-1 to 0.99997), Q14 an
+ * int16_t / 16384 (-2 to 1.99994, biquad coefficients), Q7 an
+ * int8_t / 128. Plain integers (e.g. ADC results) can be filtered
+ * as Q15 too, the coefficients set the gain. Sums are 32 bit and
+ * results saturate instead of wrapping.
+ *
+ * Multiplication:
+ *   ATmega (MUL): DSP_Mul is 16x16 -> 32 bit inline assembly with
+ *   MULS/MULSU (20 cycles, no call), Q7 products use the FMULS
+ *   instruction (__builtin_avr_fmuls, already shifted to Q15).
+ *   ATtiny (no MUL): shift and add over the bits of the smaller
+ *   operand, so small values multiply faster: ~10 cycles per bit,
+ *   at most ~170 cycles for 16 bits, ~80 for 8 bits.
+ *
+ * Cycles per sample, estimated from the code (not measured):
+ *                          ATmega328/8515     ATtiny84/85
+ *   DSP_AvgPut             ~50                ~50
+ *   DSP_MedianPut n=3/5    ~90 / ~140         ~90 / ~140
+ *   DSP_FirPut (Q15)       ~40 + ~35 per tap  ~40 + ~190 per tap
+ *   DSP_Fir7Put (Q7)       ~40 + ~20 per tap  ~40 + ~90 per tap
+ *   DSP_BiquadPut          ~180               ~950
+ *
+ *  - DSP_AvgInit/DSP_AvgPut: moving average of 2^bits samples,
+ *    bits 0 to 8 (the index is 8 bit)
+ *  - DSP_MedianInit/DSP_MedianPut: median of the last n samples
+ *    (n odd), removes spikes that an average would spread
+ *  - DSP_FirInit/DSP_FirPut/DSP_FirBlock: FIR, Q15 coefficients
+ *  - DSP_Fir7Init/DSP_Fir7Put: FIR on Q7 data, Q7 coefficients
+ *  - DSP_BiquadInit/DSP_BiquadPut/DSP_BiquadBlock: second order IIR
+ *    (direct form I), Q14 coefficients
+ *
+ * Biquad coefficients are those of the usual formulas (e.g. the
+ * Audio EQ Cookbook) divided by a0, and
+ *   y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2
+ * Low pass, Butterworth, cutoff 1/10 of the sample rate:
+ *     static const DSP_BiquadCoef LOW_PASS PROGMEM =
+ *         {DSP_Q14(0.06746), DSP_Q14(0.13491), DSP_Q14(0.06746),
+ *          DSP_Q14(-1.14298), DSP_Q14(0.41280)};
+ * Round the coefficients so that b0 + b1 + b2 = 1 + a1 + a2 for an
+ * exact DC gain of 1. Cutoffs below ~1/100 of the sample rate need
+ * more than 14 bits of precision for a1 and a2.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+// Constants from fractions, rounded (no check of the range)
+#define DSP_Q15(x) ((int16_t) ((x) * 32768.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define DSP_Q14(x) ((int16_t) ((x) * 16384.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define DSP_Q7(x) ((int8_t) ((x) * 128.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+typedef struct {
+    int16_t *buf;           // 2^bits samples, bits <= 8
+    int32_t sum;
+    uint8_t bits;
+    uint8_t i;
+} DSP_Avg;
+
+typedef struct {
+    int16_t *ring;          // last n samples, oldest at i
+    int16_t *sorted;        // the same, sorted
+    uint8_t n;
+    uint8_t i;
+} DSP_Median;
+
+typedef struct {
+    const int16_t *coef;    // taps Q15 coefficients in flash, h[0] first
+    int16_t *delay;         // taps samples
+    uint8_t taps;
+    uint8_t i;              // newest sample
+} DSP_Fir;
+
+typedef struct {
+    const int8_t *coef;     // taps Q7 coefficients in flash, h[0] first
+    int8_t *delay;          // taps samples
+    uint8_t taps;
+    uint8_t i;              // newest sample
+} DSP_Fir7;
+
+typedef struct {
+    int16_t b0, b1, b2, a1, a2;   // Q14
+} DSP_BiquadCoef;
+
+typedef struct {
+    const DSP_BiquadCoef *coef;   // in flash
+    int16_t x1, x2, y1, y2;
+} DSP_Biquad;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int16_t DSP_Sat(const int32_t x) {
+    if (x > 32767)
+        return 32767;
+    if (x < -32768)
+        return -32768;
+    return x;
+}
+
+#if defined(__AVR_HAVE_MUL__)
+
+// Signed 16x16 -> 32 bit (Atmel AVR201), MULS/MULSU need r16-r23
+static inline int32_t DSP_Mul(const int16_t a, const int16_t b) {
+    int32_t r;
+    uint8_t zero;
+
+    __asm__ (
+        "clr   %[z]"            "\n\t"
+        "muls  %B[a], %B[b]"    "\n\t"  // high x high
+        "movw  %C[r], r0"       "\n\t"
+        "mul   %A[a], %A[b]"    "\n\t"  // low x low
+        "movw  %A[r], r0"       "\n\t"
+        "mulsu %B[a], %A[b]"    "\n\t"  // high a x low b
+        "sbc   %D[r], %[z]"     "\n\t"  // sign of the partial product
+        "add   %B[r], r0"       "\n\t"
+        "adc   %C[r], r1"       "\n\t"
+        "adc   %D[r], %[z]"     "\n\t"
+        "mulsu %B[b], %A[a]"    "\n\t"  // high b x low a
+        "sbc   %D[r], %[z]"     "\n\t"
+        "add   %B[r], r0"       "\n\t"
+        "adc   %C[r], r1"       "\n\t"
+        "adc   %D[r], %[z]"     "\n\t"
+        "clr   __zero_reg__"
+        : [r] "=&r" (r), [z] "=&r" (zero)
+        : [a] "a" (a), [b] "a" (b)
+        : "r0");
+    return r;
+}
+
+// Q7 x Q7 -> Q15 (-1 x -1 gives -1)
+#define DSP_MulQ7(a, b) __builtin_avr_fmuls((a), (b))
+
+#else
+
+int32_t DSP_Mul(const int16_t a, const int16_t b);
+int16_t DSP_Mul8(const int8_t a, const int8_t b);
+
+#define DSP_MulQ7(a, b) ((int16_t) (DSP_Mul8((a), (b)) << 1))
+
+#endif
+
+// Q15 x Q15 -> Q15, rounded
+static inline int16_t DSP_MulQ15(const int16_t a, const int16_t b) {
+    return DSP_Sat((DSP_Mul(a, b) + 0x4000) >> 15);
+}
+
+void DSP_AvgInit(DSP_Avg *f, int16_t *buf, const uint8_t bits, const int16_t initial);
+int16_t DSP_AvgPut(DSP_Avg *f, const int16_t x);
+
+void DSP_MedianInit(DSP_Median *f, int16_t *buf, const uint8_t n, const int16_t initial); // buf: 2 * n samples
+int16_t DSP_MedianPut(DSP_Median *f, const int16_t x);
+
+void DSP_FirInit(DSP_Fir *f, const int16_t *coef, int16_t *delay, const uint8_t taps);
+int16_t DSP_FirPut(DSP_Fir *f, const int16_t x);
+void DSP_FirBlock(DSP_Fir *f, int16_t *data, uint16_t n);
+
+void DSP_Fir7Init(DSP_Fir7 *f, const int8_t *coef, int8_t *delay, const uint8_t taps);
+int8_t DSP_Fir7Put(DSP_Fir7 *f, const int8_t x);
+
+void DSP_BiquadInit(DSP_Biquad *f, const DSP_BiquadCoef *coef, const int16_t initial);
+int16_t DSP_BiquadPut(DSP_Biquad *f, const int16_t x);
+void DSP_BiquadBlock(DSP_Biquad *f, int16_t *data, uint16_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef __ZST_LCD_HD44780_74HC595__
+#define __ZST_LCD_HD44780_74HC595__
+
+/* ----------------------------------
+ * HD44780 BACKEND: 74HC595 SHIFT REGISTER (3 WIRES)
+ * ----------------------------------
+ *
+ * Every byte shifted into the 74HC595 and latched sets all 8
+ * outputs, wired the same way as the PCF8574 backpack:
+ *  Q0 - RS, Q1 - (R/W to GND), Q2 - En, Q3 - Backlight, Q4-Q7 - DB4-DB7
+ * Only included by zst-hd44780.c.
+ *
+ * The hardware SPI is used if the chip has one (at F_CPU/2),
+ * otherwise the USI in three-wire mode (also F_CPU/2).
+ * A whole LCD byte is 4 shifts: each nibble with En high, then
+ * with En low, so the enable strobe is made by the latch.
+ *
+ * zst-hd44780-config.h defines:
+ *  - LCD_SPI_DDR, LCD_SPI_MOSI, LCD_SPI_SCK
+ *    MOSI/DO -> SER (pin 14), SCK/USCK -> SRCLK (pin 11)
+ *  - LCD_LATCH_PORT, LCD_LATCH_DDR, LCD_LATCH
+ *    -> RCLK (pin 12). On the hardware SPI this can be the SS pin.
+ *  - LCD_SPI_SS (hardware SPI only), the SS pin on LCD_SPI_DDR.
+ *    It is made an output: an input SS going low would turn the
+ *    SPI into a slave and the LCD would stop without an error.
+ */
+
+#define LCD_RS 0
+#define LCD_E 2
+#define LCD_LED 3
+
+// 4 shifts take ~10us, wait for the controller after every byte
+#define LCD_EXEC_DELAY_US 40
+
+#if defined(SPDR)
+
+#ifndef LCD_SPI_SS
+    #error "LCD_SPI_SS is not defined in zst-hd44780-config.h (hardware SPI)"
+#endif
+
+static inline void LCD_BusInit(void) {
+    LCD_SPI_DDR |= _BV(LCD_SPI_MOSI) | _BV(LCD_SPI_SCK) | _BV(LCD_SPI_SS); // SS output: stays master
+    LCD_LATCH_DDR |= _BV(LCD_LATCH);
+    SPCR = _BV(SPE) | _BV(MSTR); // Enable SPI, Master, MSB first
+    SPSR = _BV(SPI2X); // clock rate fck/2
+}
+
+static inline void LCD_ShiftOut(const uint8_t data) {
+    SPDR = data; // Start transmission
+    while (!(SPSR & _BV(SPIF))); // Wait for transmission complete
+}
+
+#elif defined(USIDR)
+
+static inline void LCD_BusInit(void) {
+    LCD_SPI_DDR |= _BV(LCD_SPI_MOSI) | _BV(LCD_SPI_SCK);
+    LCD_LATCH_DDR |= _BV(LCD_LATCH);
+    USICR = _BV(USIWM0); // three-wire mode
+}
+
+static inline void LCD_ShiftOut(const uint8_t data) {
+    // Software clock strobe: each USICR write toggles USCK (USITC)
+    // and every second one also shifts the data register (USICLK).
+    // Unrolled so that USCK runs at F_CPU/2.
+    const uint8_t lo = _BV(USIWM0) | _BV(USITC);
+    const uint8_t hi = _BV(USIWM0) | _BV(USITC) | _BV(USICLK);
+    USIDR = data;
+    USICR = lo; USICR = hi; // MSB
+    USICR = lo; USICR = hi;
+    USICR = lo; USICR = hi;
+    USICR = lo; USICR = hi;
+    USICR = lo; USICR = hi;
+    USICR = lo; USICR = hi;
+    USICR = lo; USICR = hi;
+    USICR = lo; USICR = hi; // LSB
+}
+
+#else
+    #error "74HC595 backend needs the hardware SPI or the USI"
+#endif
+
+static inline void LCD_ShiftOutLatch(const uint8_t data) {
+    LCD_ShiftOut(data);
+    LCD_LATCH_PORT |= _BV(LCD_LATCH); // rising edge copies shift register to outputs
+    LCD_LATCH_PORT &= ~_BV(LCD_LATCH);
+}
+
+static inline void LCD_BusNibble(const uint8_t data, const uint8_t rs) {
+    uint8_t reg = (data & 0xF0) | (rs << LCD_RS) | _BV(LCD_LED);
+    LCD_ShiftOutLatch(reg | _BV(LCD_E)); // En high
+    LCD_ShiftOutLatch(reg); // En low, clocks the nibble into the LCD
+}
+
+static inline void LCD_BusByte(const uint8_t data, const uint8_t rs) {
+    LCD_BusNibble(data, rs); // send upper 4 bits
+    LCD_BusNibble(data << 4, rs); // send lower 4 bits
+}
+
+#endif
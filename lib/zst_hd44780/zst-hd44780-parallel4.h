@@ -0,0 +1,71 @@
+#ifndef __ZST_LCD_HD44780_PARALLEL4__
+#define __ZST_LCD_HD44780_PARALLEL4__
+
+/* ----------------------------------
+ * HD44780 BACKEND: 4-BIT PARALLEL
+ * ----------------------------------
+ *
+ * Uses 6 I/O pins: 2 control lines & 4 data lines.
+ * Only included by zst-hd44780.c.
+ *
+ * zst-hd44780-config.h defines:
+ *  - LCD_DATA_PORT, LCD_DATA_DDR, LCD_D4, LCD_D5, LCD_D6, LCD_D7
+ *    Data lines must be on the same port
+ *  - LCD_CONTROL_PORT, LCD_CONTROL_DDR, LCD_RS, LCD_E
+ *    Control lines must be on the same port
+ *
+ * If D4-D7 are on 4 pins in a row (e.g. PA0-PA3), a nibble is
+ * written with a single masked write instead of 4 bit tests.
+ */
+
+#include <util/delay.h>
+
+#define LCD_DATA_MASK (_BV(LCD_D4) | _BV(LCD_D5) | _BV(LCD_D6) | _BV(LCD_D7))
+
+#if (LCD_D5 == LCD_D4 + 1) && (LCD_D6 == LCD_D4 + 2) && (LCD_D7 == LCD_D4 + 3)
+    #define LCD_DATA_CONTIGUOUS
+#endif
+
+// Parallel bus is fast, wait for the controller after every byte
+#define LCD_EXEC_DELAY_US 40
+
+static inline void LCD_BusInit(void) {
+    LCD_DATA_DDR |= LCD_DATA_MASK;
+    LCD_CONTROL_DDR |= _BV(LCD_RS) | _BV(LCD_E);
+}
+
+static inline void LCD_PulseEnable(void) {
+    LCD_CONTROL_PORT |= _BV(LCD_E); // take LCD enable line high
+    _delay_us(1); // >450ns
+    LCD_CONTROL_PORT &= ~_BV(LCD_E); // take LCD enable line low
+}
+
+static inline void LCD_SendNibble(const uint8_t data) {
+#ifdef LCD_DATA_CONTIGUOUS
+    // bits 4-7 of data shifted onto D4-D7, one read-modify-write
+    LCD_DATA_PORT = (LCD_DATA_PORT & ~LCD_DATA_MASK) | (((data >> 4) << LCD_D4) & LCD_DATA_MASK);
+#else
+    LCD_DATA_PORT &= ~LCD_DATA_MASK;
+    // clear data bits
+    if (data & _BV(4)) LCD_DATA_PORT |= _BV(LCD_D4);
+    if (data & _BV(5)) LCD_DATA_PORT |= _BV(LCD_D5);
+    if (data & _BV(6)) LCD_DATA_PORT |= _BV(LCD_D6);
+    if (data & _BV(7)) LCD_DATA_PORT |= _BV(LCD_D7);
+    // set data bits
+#endif
+    LCD_PulseEnable();
+    // clock 4 bits into controller
+}
+
+static inline void LCD_BusNibble(const uint8_t data, const uint8_t rs) {
+    if (rs) LCD_CONTROL_PORT |= _BV(LCD_RS);
+    else LCD_CONTROL_PORT &= ~_BV(LCD_RS);
+    LCD_SendNibble(data);
+}
+
+static inline void LCD_BusByte(const uint8_t data, const uint8_t rs) {
+    LCD_BusNibble(data, rs); // send upper 4 bits
+    LCD_SendNibble(data << 4); // send lower 4 bits
+}
+
+#endif
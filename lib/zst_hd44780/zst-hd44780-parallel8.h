@@ -0,0 +1,45 @@
+#ifndef __ZST_LCD_HD44780_PARALLEL8__
+#define __ZST_LCD_HD44780_PARALLEL8__
+
+/* ----------------------------------
+ * HD44780 BACKEND: 8-BIT PARALLEL
+ * ----------------------------------
+ *
+ * Uses 10 I/O pins: 2 control lines & 8 data lines.
+ * A byte is one port write and one enable pulse,
+ * instead of 2 of each in 4-bit mode.
+ * Only included by zst-hd44780.c.
+ *
+ * zst-hd44780-config.h defines:
+ *  - LCD_DATA_PORT, LCD_DATA_DDR
+ *    DB0-DB7 on pins 0-7 of one whole port
+ *  - LCD_CONTROL_PORT, LCD_CONTROL_DDR, LCD_RS, LCD_E
+ *    Control lines must be on the same port
+ */
+
+#include <util/delay.h>
+
+#define LCD_BUS_8BIT
+
+// Parallel bus is fast, wait for the controller after every byte
+#define LCD_EXEC_DELAY_US 40
+
+static inline void LCD_BusInit(void) {
+    LCD_DATA_DDR = 0xFF;
+    LCD_CONTROL_DDR |= _BV(LCD_RS) | _BV(LCD_E);
+}
+
+static inline void LCD_PulseEnable(void) {
+    LCD_CONTROL_PORT |= _BV(LCD_E); // take LCD enable line high
+    _delay_us(1); // >450ns
+    LCD_CONTROL_PORT &= ~_BV(LCD_E); // take LCD enable line low
+}
+
+static inline void LCD_BusByte(const uint8_t data, const uint8_t rs) {
+    if (rs) LCD_CONTROL_PORT |= _BV(LCD_RS);
+    else LCD_CONTROL_PORT &= ~_BV(LCD_RS);
+    LCD_DATA_PORT = data; // whole byte at once
+    LCD_PulseEnable(); // clock 8 bits into controller
+}
+
+#endif
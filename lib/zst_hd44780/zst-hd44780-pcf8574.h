@@ -0,0 +1,43 @@
+#ifndef __ZST_LCD_HD44780_PCF8574__
+#define __ZST_LCD_HD44780_PCF8574__
+
+/* ----------------------------------
+ * HD44780 BACKEND: PCF8574 I2C BACKPACK
+ * ----------------------------------
+ *
+ * The PCF8574 is an 8-bit I2C port expander. Every byte written to
+ * it sets all 8 output pins. The usual backpack wiring is:
+ *  P0 - RS, P1 - R/W, P2 - En, P3 - Backlight, P4-P7 - DB4-DB7
+ * Only included by zst-hd44780.c.
+ *
+ * A whole LCD byte (2 nibbles, each with En high then En low) is
+ * sent as 4 bytes in ONE I2C transaction using LCD_I2C_Write,
+ * which the project implements with its I2C library.
+ */
+
+#define LCD_RS 0
+#define LCD_RW 1
+#define LCD_E 2
+#define LCD_LED 3
+
+// An I2C byte takes longer than the 37us the controller needs
+#define LCD_EXEC_DELAY_US 0
+
+static inline void LCD_BusInit(void) {
+}
+
+static inline void LCD_BusNibble(const uint8_t data, const uint8_t rs) {
+    uint8_t reg = (data & 0xF0) | (rs << LCD_RS) | _BV(LCD_LED); // R/W low = write
+    uint8_t buf[2] = { reg | _BV(LCD_E), reg }; // En high, then low to clock it in
+    LCD_I2C_Write(buf, 2);
+}
+
+static inline void LCD_BusByte(const uint8_t data, const uint8_t rs) {
+    uint8_t ctl = (rs << LCD_RS) | _BV(LCD_LED);
+    uint8_t hi = (data & 0xF0) | ctl;
+    uint8_t lo = (data << 4) | ctl;
+    uint8_t buf[4] = { hi | _BV(LCD_E), hi, lo | _BV(LCD_E), lo };
+    LCD_I2C_Write(buf, 4);
+}
+
+#endif
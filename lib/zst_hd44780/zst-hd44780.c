@@ -0,0 +1,121 @@
+#include <util/delay.h>
+#include <stdlib.h>
+#include "zst-hd44780.h"
+
+#if LCD_BACKEND == LCD_BACKEND_PARALLEL4
+    #include "zst-hd44780-parallel4.h"
+#elif LCD_BACKEND == LCD_BACKEND_PCF8574
+    #include "zst-hd44780-pcf8574.h"
+#elif LCD_BACKEND == LCD_BACKEND_PARALLEL8
+    #include "zst-hd44780-parallel8.h"
+#elif LCD_BACKEND == LCD_BACKEND_74HC595
+    #include "zst-hd44780-74hc595.h"
+#else
+    #error "Unknown LCD_BACKEND"
+#endif
+
+/*
+ * Every backend provides:
+ *  - LCD_BusInit() sets up the pins
+ *  - LCD_BusNibble(data, rs) writes the upper 4 bits of data with one enable pulse
+ *    (not needed if the backend defines LCD_BUS_8BIT)
+ *  - LCD_BusByte(data, rs) writes a whole byte (both nibbles in 4-bit mode)
+ *  - LCD_EXEC_DELAY_US is the wait after each byte for the controller
+ *    to execute it (37us in the datasheet), 0 if the bus is slower than that.
+ */
+
+static void LCD_SendByte(const uint8_t data, const uint8_t rs) {
+    LCD_BusByte(data, rs);
+#if LCD_EXEC_DELAY_US > 0
+    _delay_us(LCD_EXEC_DELAY_US); // wait for LCD to execute it
+#endif
+}
+
+void LCD_Init() {
+    LCD_BusInit();
+    _delay_ms(40); // wait for LCD to power up
+
+    // Controller may be in 8-bit mode or halfway through a 4-bit byte.
+    // Send "8-bit mode" 3 times so it is always in 8-bit mode...
+#ifdef LCD_BUS_8BIT
+    LCD_BusByte(0x30, 0);
+    _delay_ms(5); // >4.1ms
+    LCD_BusByte(0x30, 0);
+    _delay_us(100); // >100us
+    LCD_BusByte(0x30, 0);
+    _delay_us(100);
+
+    LCD_Cmd(0x38); // 8-bit input mode, 2 line, 5x7 matrix
+#else
+    LCD_BusNibble(0x30, 0);
+    _delay_ms(5); // >4.1ms
+    LCD_BusNibble(0x30, 0);
+    _delay_us(100); // >100us
+    LCD_BusNibble(0x30, 0);
+    _delay_us(100);
+    // ...then set it to 4-bit input mode
+    LCD_BusNibble(0x20, 0);
+    _delay_us(100);
+
+    LCD_Cmd(0x28); // 2 line, 5x7 matrix
+#endif
+    LCD_Cmd(0x0C); // turn cursor off (0x0E to enable)
+    LCD_Cmd(0x06); // cursor direction = right
+    LCD_Clear(); // start with clear display
+}
+
+void LCD_Cmd(const uint8_t cmd)
+{
+    LCD_SendByte(cmd, 0); // R/S line 0 = command data
+}
+
+void LCD_Char(const uint8_t ch)
+{
+    LCD_SendByte(ch, 1); // R/S line 1 = character data
+}
+
+void LCD_Clear() {
+    LCD_Cmd(CLEARDISPLAY);
+    _delay_ms(3); // wait for LCD to process command
+}
+
+void LCD_MoveCursor(const uint8_t x, const uint8_t y) // put LCD cursor on specified line
+{
+    uint8_t addr = 0; // line 0 begins at addr 0x00
+    switch (y) {
+        case 1: addr = 0x40; break; // line 1 begins at addr 0x40
+        case 2: addr = 0x14; break;
+        case 3: addr = 0x54; break;
+    }
+    LCD_Cmd(SETCURSOR+addr+x); // update cursor with x,y position
+}
+
+void LCD_Message(const char *text) // display string on LCD
+{
+    while (*text) // do until /0 character
+        LCD_Char(*text++); // send char & update char pointer
+}
+
+void LCD_Message_P(const char *text) // display string in flash on LCD
+{
+    char ch;
+    while ((ch = pgm_read_byte(text++))) // do until /0 character
+        LCD_Char(ch);
+}
+
+void LCD_Hex(int data)
+// displays the hex value of DATA at current LCD cursor position
+{
+    char st[8] = ""; // save enough space for result
+    itoa(data,st,16); // convert to ascii hex
+    //LCD_Message("0x"); // add prefix "0x" if desired
+    LCD_Message(st); // display it on LCD
+}
+
+void LCD_Integer(int data)
+// displays the integer value of DATA at current LCD cursor position
+{
+    char st[8] = ""; // save enough space for result
+    itoa(data,st,10); // convert to ascii
+    LCD_Message(st); // display in on LCD
+}
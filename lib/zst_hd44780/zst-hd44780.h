@@ -35,42 +35,39 @@
  *  - LCD_MoveCursor puts cursor at position (x,y)
  *
  *  - LCD_Integer displays an integer value
+ *  - LCD_Hex displays an integer value in hex
  *  - LCD_Char sends single ascii character to display
  *  - LCD_Message displays a string
-*/
-
+ *  - LCD_Message_P displays a string stored in flash (PSTR / PROGMEM)
+ *
+ * The same driver is used for every way of connecting the display.
+ * Each project has a "zst-hd44780-config.h" in its include folder
+ * which selects the backend (LCD_BACKEND) and the pins it uses.
+ * The backend is a header of static inline functions, so it compiles
+ * into plain port writes inside the driver (no function pointers).
+ *
+ * Backends:
+ *  - LCD_BACKEND_PARALLEL4: 4-bit parallel (zst-hd44780-parallel4.h)
+ *  - LCD_BACKEND_PARALLEL8: 8-bit parallel (zst-hd44780-parallel8.h)
+ *    Needs a whole port for the data lines, e.g. on the ATmega8515.
+ *  - LCD_BACKEND_74HC595:   74HC595 on the SPI or USI (zst-hd44780-74hc595.h)
+ *  - LCD_BACKEND_PCF8574:   PCF8574 I2C backpack (zst-hd44780-pcf8574.h)
+ *    The project provides LCD_I2C_Write to send bytes to the PCF8574.
+ */
 
+#include <avr/io.h>
+#include <avr/pgmspace.h>
 
-// Macros for bit manipulation
-#ifndef _BV
-    #define _BV(x) (1UL << (x))
-#endif
+#define LCD_BACKEND_PARALLEL4 1
+#define LCD_BACKEND_PCF8574   2
+#define LCD_BACKEND_PARALLEL8 3
+#define LCD_BACKEND_74HC595   4
 
-#ifndef sbi
-    #define sbi(value, bit) ((value) |= _BV(bit))
-#endif
+#include "zst-hd44780-config.h"
 
-#ifndef cbi
-    #define cbi(value, bit) ((value) &= ~_BV(bit))
+#ifndef LCD_BACKEND
+    #error "LCD_BACKEND is not defined in zst-hd44780-config.h"
 #endif
-#include <avr/io.h>
-#include <util/delay.h>
-#include <stdlib.h>
-
-
-// Set up port defines (6 I/O pins: 2 control lines & 4 data lines)
-// Data lines must be on the same port
-#define LCD_DATA_PORT PCF8574_REGISTER
-#define LCD_D4 4
-#define LCD_D5 5
-#define LCD_D6 6
-#define LCD_D7 7
-// Control lines must be on the same port
-#define LCD_CONTROL_PORT PCF8574_REGISTER
-#define LCD_RW 1
-#define LCD_RS 0
-#define LCD_E 2
-#define LCD_LED 3
 
 // The following defines are HD44780 controller commands
 #define CLEARDISPLAY 0x01
@@ -80,16 +77,17 @@
 extern "C" {
 #endif
 
-void LCD_I2C_Push(uint8_t push);
+#if LCD_BACKEND == LCD_BACKEND_PCF8574
+void LCD_I2C_Write(const uint8_t *data, uint8_t len);
+#endif
+
 void LCD_Init(void);
-void LCD_PulseEnable(void);
-void LCD_SendNibble(const uint8_t data);
-void LCD_SendByte(uint8_t data);
 void LCD_Cmd(const uint8_t cmd);
 void LCD_Char(const uint8_t ch);
 void LCD_Clear(void);
 void LCD_MoveCursor(const uint8_t x, const uint8_t y);
 void LCD_Message(const char *text);
+void LCD_Message_P(const char *text);
 void LCD_Integer(int data);
 void LCD_Hex(int data);
 
@@ -0,0 +1,210 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "zst-i2c-sched.h"
+
+/*
+ * Queue in submit order. I2C_Submit may be called from an interrupt,
+ * so the queue is only changed with interrupts disabled. I2C_Poll
+ * itself must not be called from an interrupt.
+ */
+static I2C_Job *I2C_Queue[I2C_SCHED_QUEUE];
+static uint8_t I2C_QueueLen = 0;
+
+static I2C_DeviceStats I2C_Devices[I2C_SCHED_DEVICES];
+static uint8_t I2C_DeviceCount = 0;
+static uint32_t I2C_BusyBits = 0;
+
+// Statistics entry of a device, added on first use (NULL if the table is full)
+static I2C_DeviceStats *I2C_Device(uint8_t address) {
+    uint8_t i;
+    for (i = 0; i < I2C_DeviceCount; i++)
+        if (I2C_Devices[i].address == address)
+            return &I2C_Devices[i];
+    if (I2C_DeviceCount == I2C_SCHED_DEVICES)
+        return 0;
+    I2C_Devices[I2C_DeviceCount].address = address;
+    return &I2C_Devices[I2C_DeviceCount++];
+}
+
+// A job made only of write segments
+static uint8_t I2C_IsWrite(const I2C_Job *job) {
+    uint8_t i;
+    for (i = 0; i < job->segCount; i++)
+        if (job->seg[i].flags & USI_TWI_SEG_READ)
+            return FALSE;
+    return TRUE;
+}
+
+/*
+ * Probes the addresses 0x08 to 0x77 (0x00-0x07 and 0x78-0x7F are
+ * reserved) and stores the ones that ACK in found (up to max).
+ * Returns the number of devices found. Takes about 15ms at 100KHz.
+ */
+uint8_t I2C_Scan(uint8_t *found, uint8_t max) {
+    uint8_t address, count = 0;
+
+    for (address = 0x08; address < 0x78; address++) {
+        if (USI_TWI_Probe(address)) {
+            if (count < max)
+                found[count] = address;
+            count++;
+            I2C_Device(address);
+        }
+        I2C_BusyBits += 9 + 2;
+    }
+    return count;
+}
+
+/*
+ * Queues a job. Returns FALSE if the queue is full.
+ */
+uint8_t I2C_Submit(I2C_Job *job) {
+    uint8_t sreg = SREG;
+    uint8_t ok = FALSE;
+
+    cli();
+    if (I2C_QueueLen < I2C_SCHED_QUEUE) {
+        job->status = I2C_JOB_QUEUED;
+        I2C_Queue[I2C_QueueLen++] = job;
+        ok = TRUE;
+    }
+    SREG = sreg;
+    return ok;
+}
+
+/*
+ * Runs the next transaction: the first I2C_JOB_HIGH job or else the
+ * oldest job, joined with the merge writes queued right after it.
+ * A job that is not merged is sent from its own segments, so it may
+ * have any number of them; only merged transactions are copied and
+ * limited to I2C_SCHED_MAX_SEGS segments.
+ * Returns the number of jobs completed (0 if the queue was empty).
+ */
+uint8_t I2C_Poll(void) {
+    USI_TWI_Segment seg[I2C_SCHED_MAX_SEGS];
+    I2C_Job *batch[I2C_SCHED_MAX_SEGS];
+    const USI_TWI_Segment *segs;
+    uint8_t first = 0, count = 0, nseg = 0;
+    uint8_t i, k, status, sreg;
+    uint16_t bytes = 0;
+    I2C_Job *job;
+    I2C_DeviceStats *dev;
+
+    sreg = SREG;
+    cli();
+    if (!I2C_QueueLen) {
+        SREG = sreg;
+        return 0;
+    }
+    for (i = 0; i < I2C_QueueLen; i++) {
+        if (I2C_Queue[i]->flags & I2C_JOB_HIGH) {
+            first = i;
+            break;
+        }
+    }
+    // Pick the job and the merge writes right after it
+    job = I2C_Queue[first];
+    for (i = first; i < I2C_QueueLen; i++) {
+        I2C_Job *next = I2C_Queue[i];
+        if (count) {
+            if (!(job->flags & I2C_JOB_MERGE) || !(next->flags & I2C_JOB_MERGE) ||
+                ((job->flags | next->flags) & I2C_JOB_PROBE) ||
+                next->address != job->address || !I2C_IsWrite(job) || !I2C_IsWrite(next) ||
+                !next->segCount || nseg + next->segCount > I2C_SCHED_MAX_SEGS)
+                break;
+        }
+        batch[count++] = next;
+        if (next->flags & I2C_JOB_PROBE)
+            continue;
+        nseg += next->segCount;
+        for (k = 0; k < next->segCount; k++)
+            bytes += next->seg[k].size;
+    }
+    SREG = sreg;
+
+    // One job: its own segments. Merged jobs: copied one after the other
+    // (they fit, see the check above).
+    segs = job->seg;
+    if (count > 1) {
+        nseg = 0;
+        for (i = 0; i < count; i++)
+            for (k = 0; k < batch[i]->segCount; k++)
+                seg[nseg++] = batch[i]->seg[k];
+        segs = seg;
+    }
+
+    // Jobs stay in the queue during the transfer, new ones are only appended
+    if (job->flags & I2C_JOB_PROBE) {
+        status = 0;
+        if (!USI_TWI_Probe(job->address)) {
+            status = USI_TWI_Get_State_Info();      // bus fault
+            if (!status)
+                status = USI_TWI_NO_ACK_ON_ADDRESS; // or just no ACK
+        }
+    } else {
+        status = USI_TWI_Transfer_Segments(job->address, segs, nseg) ? 0 : USI_TWI_Get_State_Info();
+    }
+    I2C_BusyBits += 9UL * (bytes + 1) + 2;
+
+    dev = I2C_Device(job->address);
+    if (dev) {
+        dev->transactions++;
+        if (status && !((job->flags & I2C_JOB_PROBE) && status == USI_TWI_NO_ACK_ON_ADDRESS))
+            dev->errors++;
+    }
+
+    sreg = SREG;
+    cli();
+    for (i = first; i + count < I2C_QueueLen; i++)
+        I2C_Queue[i] = I2C_Queue[i + count];
+    I2C_QueueLen -= count;
+    SREG = sreg;
+
+    for (i = 0; i < count; i++) {
+        batch[i]->status = status;
+        if (batch[i]->done)
+            batch[i]->done(batch[i]);
+    }
+    return count;
+}
+
+/*
+ * Queues a job and runs the queue until it is done (jobs queued
+ * earlier with a higher or the same priority run first).
+ * Returns 0 or a USI_TWI error code.
+ */
+uint8_t I2C_Run(I2C_Job *job) {
+    while (!I2C_Submit(job))
+        I2C_Poll();
+    while (job->status == I2C_JOB_QUEUED)
+        I2C_Poll();
+    return job->status;
+}
+
+/*
+ * Statistics of the devices seen (scan or transfers).
+ */
+const I2C_DeviceStats *I2C_Stats(uint8_t *count) {
+    *count = I2C_DeviceCount;
+    return I2C_Devices;
+}
+
+/*
+ * Time the bus was busy since startup, estimated from the bits sent
+ * (9 per byte, 2 for START and STOP) and I2C_SCHED_BIT_US.
+ */
+uint32_t I2C_BusyUs(void) {
+    return I2C_BusyBits * I2C_SCHED_BIT_US;
+}
+
+/*
+ * Bus utilisation in percent over elapsed_us (e.g. since startup).
+ */
+uint8_t I2C_Utilisation(uint32_t elapsed_us) {
+    uint32_t busy = I2C_BusyUs();
+    if (!elapsed_us)
+        return 0;
+    if (busy >= elapsed_us)
+        return 100;
+    return (uint8_t)(busy / (elapsed_us / 100 + 1));
+}
@@ -0,0 +1,80 @@
+#ifndef __ZST_I2C_SCHED_LIB__
+#define __ZST_I2C_SCHED_LIB__
+
+/* ----------------------------------
+ * I2C TRANSACTION SCHEDULER
+ * ----------------------------------
+ *
+ * Lets several drivers (LCD, EEPROM, sensors) share one USI I2C bus.
+ * A driver fills an I2C_Job with the slave address and a list of
+ * segments (see USI_TWI_Transfer_Segments), queues it with
+ * I2C_Submit and the main loop runs the queue with I2C_Poll. The
+ * job and its data must stay valid until job->status is no longer
+ * I2C_JOB_QUEUED.
+ *
+ *  - I2C_JOB_HIGH jobs run before normal jobs, in the order queued.
+ *  - I2C_JOB_MERGE marks writes to a device that takes a write as a
+ *    plain byte stream (e.g. PCF8574). Queued back-to-back merge
+ *    writes to the same address are sent as ONE transaction, saving
+ *    the START, address byte and STOP of each. Never set it for
+ *    devices where the first bytes are a register or memory address
+ *    (EEPROM, most sensors).
+ *  - I2C_JOB_PROBE jobs only send the address (USI_TWI_Probe), e.g.
+ *    EEPROM ACK polling. A NACK gives USI_TWI_NO_ACK_ON_ADDRESS but
+ *    is an answer, not an error in the statistics.
+ *
+ * I2C_Scan probes every address at startup. Per-device transaction
+ * and error counts, and the time the bus was busy, are kept for
+ * the application.
+ *
+ * Uses the USI_TWI_Master functions (C++), so the project must link
+ * TinyWireM.
+ */
+
+#include <stdint.h>
+#include "USI_TWI_Master.h"
+
+#ifndef I2C_SCHED_QUEUE
+#define I2C_SCHED_QUEUE     8   // jobs waiting at most
+#endif
+#ifndef I2C_SCHED_DEVICES
+#define I2C_SCHED_DEVICES   4   // devices with statistics
+#endif
+#ifndef I2C_SCHED_MAX_SEGS
+#define I2C_SCHED_MAX_SEGS  8   // segments in one merged transaction (a single job has no limit)
+#endif
+#ifndef I2C_SCHED_BIT_US
+#define I2C_SCHED_BIT_US    10  // one SCL period, 10us at 100KHz (3 at 400KHz)
+#endif
+
+#define I2C_JOB_HIGH        0x01    // latency sensitive, runs first
+#define I2C_JOB_MERGE       0x02    // may be joined with the next write to the same device
+#define I2C_JOB_PROBE       0x04    // address only, segments ignored (never merged)
+
+#define I2C_JOB_QUEUED      0xFF    // status until the job is done
+
+typedef struct I2C_Job {
+    uint8_t address;                // 7 bit slave address
+    uint8_t flags;                  // I2C_JOB_...
+    uint8_t segCount;
+    const USI_TWI_Segment *seg;
+    volatile uint8_t status;        // I2C_JOB_QUEUED, then 0 or a USI_TWI error code
+    void (*done)(struct I2C_Job *); // called when done (can be NULL)
+} I2C_Job;
+
+typedef struct {
+    uint8_t  address;
+    uint16_t transactions;          // merged writes count once
+    uint16_t errors;
+} I2C_DeviceStats;
+
+uint8_t I2C_Scan(uint8_t *found, uint8_t max);
+uint8_t I2C_Submit(I2C_Job *job);
+uint8_t I2C_Poll(void);
+uint8_t I2C_Run(I2C_Job *job);
+
+const I2C_DeviceStats *I2C_Stats(uint8_t *count);
+uint32_t I2C_BusyUs(void);
+uint8_t I2C_Utilisation(uint32_t elapsed_us);
+
+#endif
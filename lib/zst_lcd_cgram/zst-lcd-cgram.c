@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include "zst-lcd-cgram.h"
+
+/*
+ * Bar graph glyphs: 1 to 4 columns filled from the left.
+ * 0 columns is a blank and 5 columns is the full block in ROM.
+ */
+static const uint8_t LCD_GLYPH_BAR[4][8] PROGMEM = {
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},
+    {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},
+    {0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C},
+    {0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E},
+};
+
+/*
+ * Big digit segments. Each digit is made of 3x2 chars
+ * using these 8 glyphs, blanks and full blocks.
+ */
+#define BIG_LT 0 // left top
+#define BIG_UB 1 // upper bar
+#define BIG_RT 2 // right top
+#define BIG_LL 3 // left low
+#define BIG_LB 4 // lower bar
+#define BIG_LR 5 // right low
+#define BIG_UM 6 // upper + middle bar
+#define BIG_LM 7 // lower + middle bar
+#define BIG_SP 0xFE // blank
+#define BIG_FF 0xFF // full block
+
+static const uint8_t LCD_GLYPH_BIG[8][8] PROGMEM = {
+    {0x07, 0x0F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F}, // BIG_LT
+    {0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00}, // BIG_UB
+    {0x1C, 0x1E, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F}, // BIG_RT
+    {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x0F, 0x07}, // BIG_LL
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F}, // BIG_LB
+    {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1E, 0x1C}, // BIG_LR
+    {0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x1F}, // BIG_UM
+    {0x1F, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F}, // BIG_LM
+};
+
+// Top row (3 chars) then bottom row (3 chars) of each digit
+static const uint8_t LCD_BIG_DIGITS[10][6] PROGMEM = {
+    {BIG_LT, BIG_UB, BIG_RT,   BIG_LL, BIG_LB, BIG_LR}, // 0
+    {BIG_UB, BIG_RT, BIG_SP,   BIG_LB, BIG_FF, BIG_LB}, // 1
+    {BIG_UM, BIG_UM, BIG_RT,   BIG_LL, BIG_LM, BIG_LM}, // 2
+    {BIG_UM, BIG_UM, BIG_RT,   BIG_LM, BIG_LM, BIG_LR}, // 3
+    {BIG_LL, BIG_LB, BIG_FF,   BIG_SP, BIG_SP, BIG_FF}, // 4
+    {BIG_LL, BIG_UM, BIG_UM,   BIG_LM, BIG_LM, BIG_LR}, // 5
+    {BIG_LT, BIG_UM, BIG_UM,   BIG_LL, BIG_LM, BIG_LR}, // 6
+    {BIG_UB, BIG_UB, BIG_RT,   BIG_SP, BIG_SP, BIG_FF}, // 7
+    {BIG_LT, BIG_UM, BIG_RT,   BIG_LL, BIG_LM, BIG_LR}, // 8
+    {BIG_LT, BIG_UM, BIG_RT,   BIG_SP, BIG_SP, BIG_FF}, // 9
+};
+
+uint16_t LCD_GlyphHits = 0;
+uint16_t LCD_GlyphMisses = 0;
+
+static const uint8_t *LCD_SlotGlyph[LCD_CGRAM_SLOTS]; // PROGMEM glyph in each slot (NULL = empty)
+static uint8_t LCD_SlotOrder[LCD_CGRAM_SLOTS] = {7, 6, 5, 4, 3, 2, 1, 0}; // most recently used slot first
+
+void LCD_GlyphCacheReset(void) {
+    for (uint8_t i = 0; i < LCD_CGRAM_SLOTS; i++) {
+        LCD_SlotGlyph[i] = NULL;
+        LCD_SlotOrder[i] = LCD_CGRAM_SLOTS - 1 - i; // slot 0 gets used first
+    }
+}
+
+static void LCD_GlyphUpload(const uint8_t slot, const uint8_t *glyph) {
+    LCD_Cmd(SETCGRAMADDR | (slot << 3)); // each slot is 8 bytes of CGRAM
+    for (uint8_t row = 0; row < 8; row++)
+        LCD_Char(pgm_read_byte(glyph + row)); // address auto-increments
+}
+
+uint8_t LCD_Glyph(const uint8_t *glyph) {
+    uint8_t i, slot;
+
+    // Search from the most recently used slot. Stops at the LRU slot.
+    for (i = 0; i < LCD_CGRAM_SLOTS - 1; i++) {
+        if (LCD_SlotGlyph[LCD_SlotOrder[i]] == glyph) break;
+    }
+    slot = LCD_SlotOrder[i];
+
+    if (LCD_SlotGlyph[slot] == glyph) {
+        LCD_GlyphHits++;
+    } else { // not found, replace the LRU slot
+        LCD_GlyphMisses++;
+        LCD_GlyphUpload(slot, glyph);
+        LCD_SlotGlyph[slot] = glyph;
+    }
+
+    // Move slot to the front of the list
+    for (; i; i--)
+        LCD_SlotOrder[i] = LCD_SlotOrder[i - 1];
+    LCD_SlotOrder[0] = slot;
+
+    return slot;
+}
+
+void LCD_BarGraph(const uint8_t x, const uint8_t y, const uint8_t width,
+                  uint16_t value, const uint16_t max) {
+    if (value > max) value = max;
+    uint8_t cols = max ? ((uint32_t) value * width * 5) / max : 0; // number of filled columns, empty bar when max is 0
+    uint8_t partial = LCD_CHAR_BLANK;
+    if (cols % 5) {
+        partial = LCD_Glyph(LCD_GLYPH_BAR[(cols % 5) - 1]); // before moving cursor
+    }
+
+    LCD_MoveCursor(x, y);
+    for (uint8_t i = 0; i < width; i++) {
+        if (cols >= 5) {
+            LCD_Char(LCD_CHAR_FULL);
+            cols -= 5;
+        } else if (cols) {
+            LCD_Char(partial);
+            cols = 0;
+        } else {
+            LCD_Char(LCD_CHAR_BLANK);
+        }
+    }
+}
+
+void LCD_BigDigit(const uint8_t x, const uint8_t y, const uint8_t digit) {
+    uint8_t chars[6];
+
+    // Get all char codes before moving cursor
+    for (uint8_t i = 0; i < 6; i++) {
+        uint8_t seg = pgm_read_byte(&LCD_BIG_DIGITS[digit][i]);
+        if (seg == BIG_SP) chars[i] = LCD_CHAR_BLANK;
+        else if (seg == BIG_FF) chars[i] = LCD_CHAR_FULL;
+        else chars[i] = LCD_Glyph(LCD_GLYPH_BIG[seg]);
+    }
+
+    LCD_MoveCursor(x, y);
+    LCD_Char(chars[0]); LCD_Char(chars[1]); LCD_Char(chars[2]);
+    LCD_MoveCursor(x, y + 1);
+    LCD_Char(chars[3]); LCD_Char(chars[4]); LCD_Char(chars[5]);
+}
+
+void LCD_BigInteger(uint8_t x, const uint8_t y, unsigned int data)
+// displays the integer value of DATA with big digits, each 4 chars apart
+{
+    char st[8] = ""; // save enough space for result
+    utoa(data, st, 10); // convert to ascii
+    for (char *s = st; *s; s++, x += 4)
+        LCD_BigDigit(x, y, *s - '0');
+}
@@ -0,0 +1,59 @@
+#ifndef __ZST_LCD_CGRAM_LIB__
+#define __ZST_LCD_CGRAM_LIB__
+
+/* ----------------------------------
+ * HD44780 CGRAM GLYPH CACHE
+ * ----------------------------------
+ *
+ * The HD44780 only has 8 CGRAM slots (char codes 0-7) for custom
+ * characters. Uploading one takes 9 writes to the controller, which
+ * is slow over I2C. Glyphs are stored in PROGMEM (8 rows of 5 bits)
+ * and only uploaded when they are not already in a slot. When all
+ * slots are used, the least recently used slot is replaced.
+ *
+ * NOTE: Replacing a slot changes every character on the display
+ * that uses it, so keep at most 8 different glyphs on screen.
+ *
+ * NOTE: An upload leaves the LCD address counter in CGRAM. Always
+ * get the char codes with LCD_Glyph BEFORE calling LCD_MoveCursor.
+ *
+ *  - LCD_GlyphCacheReset forgets all slots (e.g. after LCD_Init)
+ *  - LCD_Glyph returns the char code of a glyph, uploading it if needed
+ *
+ *  - LCD_BarGraph draws a horizontal bar graph (5 steps per char)
+ *  - LCD_BigDigit draws a digit 3 chars wide and 2 rows high
+ *  - LCD_BigInteger draws an unsigned integer with big digits
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "zst-hd44780.h"
+
+#define LCD_CGRAM_SLOTS 8
+#define SETCGRAMADDR 0x40
+
+// Characters from the HD44780 (A00) character ROM
+#define LCD_CHAR_BLANK 0x20
+#define LCD_CHAR_FULL 0xFF
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cache statistics, never reset by the library
+extern uint16_t LCD_GlyphHits;
+extern uint16_t LCD_GlyphMisses;
+
+void LCD_GlyphCacheReset(void);
+uint8_t LCD_Glyph(const uint8_t *glyph);
+
+void LCD_BarGraph(const uint8_t x, const uint8_t y, const uint8_t width,
+                  uint16_t value, const uint16_t max);
+void LCD_BigDigit(const uint8_t x, const uint8_t y, const uint8_t digit);
+void LCD_BigInteger(uint8_t x, const uint8_t y, unsigned int data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
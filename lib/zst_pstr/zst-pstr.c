@@ -0,0 +1,6 @@
+#include "zst-pstr.h"
+
+// Store every string of the table once in flash
+#define PSTR_ENTRY(name, text) const char name[] PROGMEM = text;
+#include "zst-pstr-table.h"
+#undef PSTR_ENTRY
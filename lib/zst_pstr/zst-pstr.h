@@ -0,0 +1,38 @@
+#ifndef __ZST_PSTR_LIB__
+#define __ZST_PSTR_LIB__
+
+/* ----------------------------------
+ * FLASH STRING TABLE
+ * ----------------------------------
+ *
+ * String literals like "Hello" are copied from flash to SRAM at
+ * startup (.data section) and stay there. PSTR("Hello") keeps a
+ * string in flash only, but makes a new copy for every place it
+ * is written, so a label used in 3 places is stored 3 times.
+ *
+ * Each project lists its strings ONCE in "zst-pstr-table.h" in
+ * its include folder:
+ *
+ *     PSTR_ENTRY(STR_HELLO, "Hello World.")
+ *     PSTR_ENTRY(STR_ADC,   "ADC: ")
+ *
+ * STR_HELLO is then a string in flash that can be used anywhere,
+ * e.g. LCD_Message_P(STR_HELLO). zst-pstr.c stores every entry
+ * once in flash.
+ */
+
+#include <avr/pgmspace.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PSTR_ENTRY(name, text) extern const char name[] PROGMEM;
+#include "zst-pstr-table.h"
+#undef PSTR_ENTRY
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
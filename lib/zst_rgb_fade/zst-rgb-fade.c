@@ -0,0 +1,162 @@
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "zst-rgb-fade.h"
+
+// round(65535 * (i / 255)^2.2)
+static const uint16_t FADE_GAMMA[256] PROGMEM = {
+        0,     0,     2,     4,     7,    11,    17,    24,
+       32,    42,    53,    65,    79,    94,   111,   129,
+      148,   169,   192,   216,   242,   270,   299,   330,
+      362,   396,   432,   469,   508,   549,   591,   635,
+      681,   729,   779,   830,   883,   938,   995,  1053,
+     1113,  1175,  1239,  1305,  1373,  1443,  1514,  1587,
+     1663,  1740,  1819,  1900,  1983,  2068,  2155,  2243,
+     2334,  2427,  2521,  2618,  2717,  2817,  2920,  3024,
+     3131,  3240,  3350,  3463,  3578,  3694,  3813,  3934,
+     4057,  4182,  4309,  4438,  4570,  4703,  4838,  4976,
+     5115,  5257,  5401,  5547,  5695,  5845,  5998,  6152,
+     6309,  6468,  6629,  6792,  6957,  7124,  7294,  7466,
+     7640,  7816,  7994,  8175,  8358,  8543,  8730,  8919,
+     9111,  9305,  9501,  9699,  9900, 10102, 10307, 10515,
+    10724, 10936, 11150, 11366, 11585, 11806, 12029, 12254,
+    12482, 12712, 12944, 13179, 13416, 13655, 13896, 14140,
+    14386, 14635, 14885, 15138, 15394, 15652, 15912, 16174,
+    16439, 16706, 16975, 17247, 17521, 17798, 18077, 18358,
+    18642, 18928, 19216, 19507, 19800, 20095, 20393, 20694,
+    20996, 21301, 21609, 21919, 22231, 22546, 22863, 23182,
+    23504, 23829, 24156, 24485, 24817, 25151, 25487, 25826,
+    26168, 26512, 26858, 27207, 27558, 27912, 28268, 28627,
+    28988, 29351, 29717, 30086, 30457, 30830, 31206, 31585,
+    31966, 32349, 32735, 33124, 33514, 33908, 34304, 34702,
+    35103, 35507, 35913, 36321, 36732, 37146, 37562, 37981,
+    38402, 38825, 39252, 39680, 40112, 40546, 40982, 41421,
+    41862, 42306, 42753, 43202, 43654, 44108, 44565, 45025,
+    45487, 45951, 46418, 46888, 47360, 47835, 48313, 48793,
+    49275, 49761, 50249, 50739, 51232, 51728, 52226, 52727,
+    53230, 53736, 54245, 54756, 55270, 55787, 56306, 56828,
+    57352, 57879, 58409, 58941, 59476, 60014, 60554, 61097,
+    61642, 62190, 62741, 63295, 63851, 64410, 64971, 65535,
+};
+
+static uint16_t FADE_Value[3];          // 8.8 fixed point
+static int16_t FADE_Step[3];            // added every step, 8.8
+static uint8_t FADE_Target[3];
+static volatile uint16_t FADE_Steps;    // steps left
+static uint8_t FADE_Div;                // overflows until the next step (read in asm)
+
+static void FADE_Output(void) {
+    FADE_SET_R(pgm_read_word(&FADE_GAMMA[FADE_Value[0] >> 8]));
+    FADE_SET_G(pgm_read_word(&FADE_GAMMA[FADE_Value[1] >> 8]));
+    FADE_SET_B(pgm_read_word(&FADE_GAMMA[FADE_Value[2] >> 8]));
+}
+
+// One fade step, every FADE_TICK_DIV overflows. Entered by a jump from
+// the overflow interrupt below, so it is an interrupt itself (signal:
+// saves what it uses, ends with reti). The "__vector" prefix keeps
+// avr-gcc from warning about a misspelled interrupt name.
+void __vector_fade_step(void) __attribute__((signal, used));
+
+void __vector_fade_step(void) {
+    uint8_t i;
+
+    FADE_Div = FADE_TICK_DIV;
+    if (!FADE_Steps)
+        return;
+
+    if (--FADE_Steps) {
+        for (i = 0; i < 3; i++)
+            FADE_Value[i] += FADE_Step[i];
+    } else {
+        for (i = 0; i < 3; i++) // last step: exactly on the target
+            FADE_Value[i] = FADE_Target[i] << 8;
+    }
+    FADE_Output();
+}
+
+// Runs on every overflow (31250/s at 8MHz) only to count: naked, as
+// a C interrupt calling FADE_SET_x saves all the call-clobbered
+// registers even when it just counts (~70 cycles). This saves one
+// register and SREG: ~26 cycles with the interrupt entry and reti.
+ISR(FADE_vect, ISR_NAKED) {
+    __asm__ __volatile__ (
+        "push  r24"                     "\n\t"
+        "in    r24, __SREG__"           "\n\t"
+        "push  r24"                     "\n\t"
+        "lds   r24, %[div]"             "\n\t"
+        "dec   r24"                     "\n\t"
+        "sts   %[div], r24"             "\n\t"
+        "breq  1f"                      "\n\t"
+        "pop   r24"                     "\n\t"
+        "out   __SREG__, r24"           "\n\t"
+        "pop   r24"                     "\n\t"
+        "reti"                          "\n"
+        "1:"                            "\n\t"
+        "pop   r24"                     "\n\t"  // step due: leave as entered
+        "out   __SREG__, r24"           "\n\t"
+        "pop   r24"                     "\n\t"
+        "%~jmp __vector_fade_step"
+        :
+        : [div] "i" (&FADE_Div));
+}
+
+void FADE_Init(void) {
+    uint8_t i;
+
+    for (i = 0; i < 3; i++) {
+        FADE_Value[i] = 0;
+        FADE_Target[i] = 0;
+    }
+    FADE_Steps = 0;
+    FADE_Div = FADE_TICK_DIV;
+    FADE_Output();
+    FADE_TIMSK |= _BV(FADE_TOIE);
+}
+
+void FADE_To(const uint8_t r, const uint8_t g, const uint8_t b, const uint16_t ms) {
+    uint16_t steps = (uint32_t) ms * FADE_STEP_HZ / 1000;
+    uint16_t value[3];
+    int16_t step[3];
+    const uint8_t target[3] = {r, g, b};
+    uint8_t i, sreg = SREG;
+
+    if (!steps)
+        steps = 1;
+
+    cli();
+    for (i = 0; i < 3; i++)
+        value[i] = FADE_Value[i];
+    SREG = sreg;
+
+    // Divisions with the interrupt on; a step taken meanwhile only
+    // shifts the path a little, the last step lands on the target.
+    for (i = 0; i < 3; i++)
+        step[i] = steps > 1 ? (((int32_t) target[i] << 8) - value[i]) / steps : 0;
+
+    cli();
+    for (i = 0; i < 3; i++) {
+        FADE_Step[i] = step[i];
+        FADE_Target[i] = target[i];
+    }
+    FADE_Steps = steps;
+    SREG = sreg;
+}
+
+uint8_t FADE_Busy(void) {
+    uint8_t sreg = SREG;
+    uint8_t busy;
+
+    cli();
+    busy = FADE_Steps != 0;
+    SREG = sreg;
+    return busy;
+}
+
+void FADE_Get(uint8_t *r, uint8_t *g, uint8_t *b) {
+    uint8_t sreg = SREG;
+
+    cli();
+    *r = FADE_Value[0] >> 8;
+    *g = FADE_Value[1] >> 8;
+    *b = FADE_Value[2] >> 8;
+    SREG = sreg;
+}
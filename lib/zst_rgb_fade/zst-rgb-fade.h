@@ -0,0 +1,78 @@
+#ifndef __ZST_RGB_FADE_LIB__
+#define __ZST_RGB_FADE_LIB__
+
+/* ----------------------------------
+ * RGB LED FADE ENGINE
+ * ----------------------------------
+ *
+ * Fades 3 PWM channels together from their current colour to a
+ * target colour in a given time. The main loop only posts targets
+ * (FADE_To) and goes on; a timer overflow interrupt moves every
+ * channel one step FADE_TICK_HZ times per second. The values are
+ * kept in 8.8 fixed point so slow fades stay smooth, and go through
+ * a gamma table (2.2, 16 bit, in flash) before the outputs, so equal
+ * steps look equally bright to the eye. 16 bit gamma values keep
+ * the dark end smooth on outputs with more than 8 bits.
+ *
+ * The PWM itself (mode, pins, inverting) is set up by the project.
+ * Each project has a "zst-rgb-fade-config.h" in its include folder:
+ *
+ *     // Outputs, v = gamma corrected brightness 0 to 65535
+ *     #define FADE_SET_R(v) (OCR0A = (v) >> 8)
+ *     #define FADE_SET_G(v) PWM1_SetLevel(PWM1_A, (v))
+ *     #define FADE_SET_B(v) PWM1_SetLevel(PWM1_B, (v))
+ *     // Interrupt that runs the fades, and its overflow rate
+ *     #define FADE_vect TIM0_OVF_vect
+ *     #define FADE_TIMSK TIMSK0
+ *     #define FADE_TOIE TOIE0
+ *     #define FADE_OVF_HZ (F_CPU / 256)
+ *
+ *  - FADE_Init sets all channels to 0 and starts the interrupt
+ *    (needs sei(), left to the project)
+ *  - FADE_To starts a fade to (r, g, b) lasting ms
+ *  - FADE_Busy is true while a fade is running
+ *  - FADE_Get returns the current colour (before the gamma table)
+ *
+ * Cost (estimated from the code, not measured): the overflow
+ * interrupt only counts, ~26 cycles with the entry and reti (hand
+ * written, no calls): ~10% of the CPU at 8MHz with 31250 overflows/s,
+ * ~1.3% with 3906/s. Every FADE_TICK_DIV-th overflow jumps to the
+ * step, ~90 cycles plus the outputs and its saved registers (~250
+ * with PWM1_SetLevel), at ~250 steps/s: under 1%.
+ */
+
+#include <avr/io.h>
+#include "zst-rgb-fade-config.h"
+
+#if !defined(FADE_SET_R) || !defined(FADE_SET_G) || !defined(FADE_SET_B)
+    #error "FADE_SET_R/G/B are not defined in zst-rgb-fade-config.h"
+#endif
+#if !defined(FADE_vect) || !defined(FADE_OVF_HZ)
+    #error "FADE_vect and FADE_OVF_HZ are not defined in zst-rgb-fade-config.h"
+#endif
+
+// Fade steps per second
+#ifndef FADE_TICK_HZ
+#define FADE_TICK_HZ 250
+#endif
+#define FADE_TICK_DIV (FADE_OVF_HZ / FADE_TICK_HZ)
+#define FADE_STEP_HZ (FADE_OVF_HZ / FADE_TICK_DIV)   // real step rate (250 at 31250 overflows/s, 260 at 3906/s)
+
+#if FADE_TICK_DIV < 1 || FADE_TICK_DIV > 255
+    #error "FADE_TICK_HZ out of range for FADE_OVF_HZ"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void FADE_Init(void);
+void FADE_To(const uint8_t r, const uint8_t g, const uint8_t b, const uint16_t ms);
+uint8_t FADE_Busy(void);
+void FADE_Get(uint8_t *r, uint8_t *g, uint8_t *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
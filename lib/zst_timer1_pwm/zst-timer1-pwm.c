@@ -0,0 +1,136 @@
+#include <avr/interrupt.h>
+#include "zst-timer1-pwm.h"
+
+#if defined(TIM1_OVF_vect)
+    #define PWM1_OVF_vect TIM1_OVF_vect     // ATtiny24/44/84
+#else
+    #define PWM1_OVF_vect TIMER1_OVF_vect
+#endif
+
+#if defined(TIMSK1)
+    #define PWM1_TIMSK TIMSK1
+#else
+    #define PWM1_TIMSK TIMSK
+#endif
+
+#define PWM1_MODE_A (_BV(WGM11))                  // mode 14, TOP is ICR1
+#define PWM1_MODE_B (_BV(WGM13) | _BV(WGM12))
+
+static const uint16_t PWM1_DIV[5] = {1, 8, 64, 256, 1024}; // CS12:0 = 1 to 5
+
+static volatile uint16_t PWM1_TopValue = PWM1_TOP;
+static volatile uint8_t PWM1_Clock = PWM1_CS;   // CS12:0
+static volatile uint16_t PWM1_Next[2];          // written at the next overflow
+static volatile uint8_t PWM1_NewConfig;         // TOP and clock to write too
+static volatile uint8_t PWM1_Dirty;             // channels to write, bit 0 = A, bit 1 = B
+
+ISR(PWM1_OVF_vect) {
+    // TOV1 is set at TOP, TCNT1 is at 0 one timer clock later. ICR1 is
+    // not buffered: the new TOP must still be ahead of TCNT1 (see the
+    // latency note in zst-timer1-pwm.h), OCR1A/B are buffered
+    if (PWM1_NewConfig) {
+        ICR1 = PWM1_TopValue;
+        TCCR1B = PWM1_MODE_B | PWM1_Clock;
+        PWM1_NewConfig = 0;
+    }
+    if (PWM1_Dirty & _BV(PWM1_A))
+        OCR1A = PWM1_Next[PWM1_A];
+    if (PWM1_Dirty & _BV(PWM1_B))
+        OCR1B = PWM1_Next[PWM1_B];
+    PWM1_Dirty = 0;
+    PWM1_TIMSK &= ~_BV(TOIE1); // nothing left to update
+}
+
+void PWM1_Init(const uint8_t outputs) {
+    TCCR1B = 0; // stop
+    PWM1_TopValue = PWM1_TOP;
+    PWM1_Clock = PWM1_CS;
+    PWM1_Next[PWM1_A] = 0;
+    PWM1_Next[PWM1_B] = 0;
+    PWM1_NewConfig = 0;
+    PWM1_Dirty = 0;
+
+    TCNT1 = 0;
+    ICR1 = PWM1_TOP;
+    OCR1A = 0;
+    OCR1B = 0;
+    TCCR1A = outputs | PWM1_MODE_A;
+    TCCR1B = PWM1_MODE_B | PWM1_CS; // begin PWM
+}
+
+uint8_t PWM1_Config(const uint32_t hz, const uint8_t bits) {
+    uint32_t counts = 0;
+    uint8_t cs, sreg = SREG;
+
+    if (!hz)
+        return 0;
+    for (cs = 1; cs <= 5; cs++) {
+        counts = F_CPU / PWM1_DIV[cs - 1] / hz;
+        if (counts <= 65536UL)
+            break;
+    }
+    if (cs > 5 || counts < (1UL << bits) || counts < 2)
+        return 0;
+
+    cli();
+    // Keep the duty cycles within the new TOP
+    if (PWM1_Next[PWM1_A] > counts - 1) {
+        PWM1_Next[PWM1_A] = counts - 1;
+        PWM1_Dirty |= _BV(PWM1_A);
+    }
+    if (PWM1_Next[PWM1_B] > counts - 1) {
+        PWM1_Next[PWM1_B] = counts - 1;
+        PWM1_Dirty |= _BV(PWM1_B);
+    }
+    PWM1_TopValue = counts - 1;
+    PWM1_Clock = cs;
+    PWM1_NewConfig = 1;
+    PWM1_TIMSK |= _BV(TOIE1);
+    SREG = sreg;
+    return 1;
+}
+
+void PWM1_Set(const uint8_t channel, uint16_t value) {
+    uint8_t sreg = SREG;
+
+    cli();
+    if (value > PWM1_TopValue)
+        value = PWM1_TopValue;
+    PWM1_Next[channel] = value;
+    PWM1_Dirty |= _BV(channel);
+    PWM1_TIMSK |= _BV(TOIE1);
+    SREG = sreg;
+}
+
+void PWM1_SetLevel(const uint8_t channel, const uint16_t level) {
+    PWM1_Set(channel, ((uint32_t) level * (PWM1_Top() + 1UL)) >> 16);
+}
+
+uint32_t PWM1_Hz(void) {
+    uint8_t sreg = SREG;
+    uint32_t hz;
+
+    cli();
+    hz = F_CPU / PWM1_DIV[PWM1_Clock - 1] / (PWM1_TopValue + 1UL);
+    SREG = sreg;
+    return hz;
+}
+
+uint8_t PWM1_Bits(void) {
+    uint32_t counts = PWM1_Top() + 1UL;
+    uint8_t bits = 0;
+
+    while (counts >>= 1)
+        bits++;
+    return bits;
+}
+
+uint16_t PWM1_Top(void) {
+    uint8_t sreg = SREG;
+    uint16_t top;
+
+    cli();
+    top = PWM1_TopValue;
+    SREG = sreg;
+    return top;
+}
@@ -0,0 +1,113 @@
+#ifndef __ZST_TIMER1_PWM_LIB__
+#define __ZST_TIMER1_PWM_LIB__
+
+/* ----------------------------------
+ * TIMER1 HIGH RESOLUTION PWM
+ * ----------------------------------
+ *
+ * Timer1 fast PWM, mode 14 (TOP = ICR1), on OC1A and OC1B. TOP sets
+ * both the frequency and the resolution:
+ *   frequency = F_CPU / (prescaler * (TOP + 1))
+ *   bits      = log2(TOP + 1)
+ *
+ *   8MHz, no prescaler:  8 bit 31.2kHz   10 bit 7.8kHz
+ *                       12 bit 1.95kHz   16 bit 122Hz
+ *
+ * PWM1_HZ and PWM1_BITS are solved at compile time: the smallest
+ * prescaler whose TOP fits in 16 bits (the most resolution for the
+ * frequency), and an #error when TOP + 1 < 2^PWM1_BITS. PWM1_Init
+ * uses them. PWM1_Config solves the same at run time.
+ *
+ * Glitch free updates: PWM1_Set only stores the new values and turns
+ * on the overflow interrupt. At the next overflow the interrupt
+ * writes the channels that were set (and TOP/prescaler after
+ * PWM1_Config), then turns itself off again. Both channels change in
+ * the same period, and a 16 bit register is never half written when
+ * the timer loads it. The interrupt only runs when there is something
+ * to update, and needs sei() (left to the project).
+ *
+ * ICR1 (TOP) is not double buffered. The interrupt writes it after
+ * the overflow, while TCNT1 counts up from 0, so PWM1_Config is only
+ * glitch free while the interrupt latency, in timer counts, stays
+ * below the new TOP (e.g. 399 cycles at 20kHz without prescaler).
+ * A later write lets TCNT1 pass TOP and run to 0xFFFF once: one
+ * period of 65536 counts (8ms at 8MHz). Channel updates (OCR1A/B)
+ * are buffered and have no such limit.
+ *
+ * A channel never given to PWM1_Set can be written directly (OCR1A =
+ * value) from another interrupt, e.g. a control loop: the hardware
+ * buffers OCR1x in fast PWM until the next period. The value is not
+ * checked against TOP then.
+ *
+ *  - PWM1_Init starts the PWM (PWM1_HZ, PWM1_BITS) on the given outputs
+ *  - PWM1_Config changes frequency and resolution, 0 if not possible
+ *  - PWM1_Set sets a channel, 0 to PWM1_Top()
+ *  - PWM1_SetLevel sets a channel, 0 to 65535 scaled to TOP
+ *  - PWM1_Hz, PWM1_Bits, PWM1_Top report the PWM really running
+ */
+
+#include <avr/io.h>
+
+// Default: 10 bit, 7.8kHz at 8MHz
+#ifndef PWM1_HZ
+#define PWM1_HZ (F_CPU / 1024)
+#endif
+#ifndef PWM1_BITS
+#define PWM1_BITS 10
+#endif
+
+#define PWM1_COUNTS(n) (F_CPU / (n) / PWM1_HZ)  // timer counts per period
+
+#if PWM1_COUNTS(1) <= 65536UL
+#define PWM1_PRESCALE 1
+#define PWM1_CS (_BV(CS10))
+#elif PWM1_COUNTS(8) <= 65536UL
+#define PWM1_PRESCALE 8
+#define PWM1_CS (_BV(CS11))
+#elif PWM1_COUNTS(64) <= 65536UL
+#define PWM1_PRESCALE 64
+#define PWM1_CS (_BV(CS11) | _BV(CS10))
+#elif PWM1_COUNTS(256) <= 65536UL
+#define PWM1_PRESCALE 256
+#define PWM1_CS (_BV(CS12))
+#elif PWM1_COUNTS(1024) <= 65536UL
+#define PWM1_PRESCALE 1024
+#define PWM1_CS (_BV(CS12) | _BV(CS10))
+#else
+    #error "PWM1_HZ too low for Timer1"
+#endif
+
+#define PWM1_TOP (PWM1_COUNTS(PWM1_PRESCALE) - 1)
+#define PWM1_REAL_HZ (F_CPU / PWM1_PRESCALE / (PWM1_TOP + 1))
+
+#if PWM1_TOP + 1 < (1UL << PWM1_BITS)
+    #error "PWM1_BITS too high for PWM1_HZ: at most F_CPU / 2^PWM1_BITS Hz"
+#endif
+
+// Channels
+#define PWM1_A 0    // OC1A
+#define PWM1_B 1    // OC1B
+
+// Outputs for PWM1_Init (the pins must be set as outputs)
+#define PWM1_OUT_A (_BV(COM1A1))                    // set at BOTTOM, cleared at compare match
+#define PWM1_OUT_A_INV (_BV(COM1A1) | _BV(COM1A0))  // inverting (active LOW loads)
+#define PWM1_OUT_B (_BV(COM1B1))
+#define PWM1_OUT_B_INV (_BV(COM1B1) | _BV(COM1B0))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void PWM1_Init(const uint8_t outputs);
+uint8_t PWM1_Config(const uint32_t hz, const uint8_t bits);
+void PWM1_Set(const uint8_t channel, uint16_t value);
+void PWM1_SetLevel(const uint8_t channel, const uint16_t level);
+uint32_t PWM1_Hz(void);
+uint8_t PWM1_Bits(void);
+uint16_t PWM1_Top(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
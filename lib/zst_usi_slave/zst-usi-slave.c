@@ -0,0 +1,173 @@
+#include <avr/interrupt.h>
+#include "zst-usi-slave.h"
+
+#if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
+    #define DDR_USI             DDRB
+    #define PORT_USI            PORTB
+    #define PIN_USI             PINB
+    #define PIN_USI_SDA         PB0
+    #define PIN_USI_SCL         PB2
+    #define USI_SLAVE_START_vect    USI_START_vect
+    #define USI_SLAVE_OVF_vect      USI_OVF_vect
+#elif defined(__AVR_ATtiny24__) || defined(__AVR_ATtiny44__) || defined(__AVR_ATtiny84__)
+    #define DDR_USI             DDRA
+    #define PORT_USI            PORTA
+    #define PIN_USI             PINA
+    #define PIN_USI_SDA         PA6
+    #define PIN_USI_SCL         PA4
+    #define USI_SLAVE_START_vect    USI_STR_vect
+    #define USI_SLAVE_OVF_vect      USI_OVF_vect
+#elif defined(__AVR_ATtiny2313__) || defined(__AVR_ATtiny4313__)
+    #define DDR_USI             DDRB
+    #define PORT_USI            PORTB
+    #define PIN_USI             PINB
+    #define PIN_USI_SDA         PB5
+    #define PIN_USI_SCL         PB7
+    #define USI_SLAVE_START_vect    USI_START_vect
+    #define USI_SLAVE_OVF_vect      USI_OVERFLOW_vect
+#else
+    #error "USI slave: device not supported"
+#endif
+
+// States after each counter overflow
+#define STATE_ADDRESS       0   // address byte received
+#define STATE_SEND_DATA     1   // ACK sent/received: send a byte
+#define STATE_REQUEST_ACK   2   // byte sent: read (N)ACK from master
+#define STATE_CHECK_ACK     3   // (N)ACK from master received
+#define STATE_REQUEST_DATA  4   // ACK sent: receive a byte
+#define STATE_GET_DATA      5   // byte received: store and ACK
+
+// USICR: wait for START / hold SCL low after START and counter overflow
+#define USICR_WAIT_START    ((1<<USISIE)|(0<<USIOIE)|(1<<USIWM1)|(0<<USIWM0)|(1<<USICS1)|(0<<USICS0)|(0<<USICLK)|(0<<USITC))
+#define USICR_TRANSFER      ((1<<USISIE)|(1<<USIOIE)|(1<<USIWM1)|(1<<USIWM0)|(1<<USICS1)|(0<<USICS0)|(0<<USICLK)|(0<<USITC))
+
+// USISR: clear the flags (not USISIF) and count 8 bits (16 edges) or 1 bit (2 edges)
+#define USISR_8BIT          ((0<<USISIF)|(1<<USIOIF)|(1<<USIPF)|(1<<USIDC)|(0x0<<USICNT0))
+#define USISR_1BIT          ((0<<USISIF)|(1<<USIOIF)|(1<<USIPF)|(1<<USIDC)|(0xE<<USICNT0))
+
+static uint8_t slave_address;
+static uint8_t state;
+static uint8_t pointer;                 // register pointer
+static uint8_t first_write;             // next received byte is the register pointer
+
+static uint8_t regs[3][USI_SLAVE_REGS];
+static volatile uint8_t latest = 0;     // buffer with the newest data
+static volatile uint8_t active = 0;     // buffer read by the current transaction
+static uint8_t back = 1;                // buffer being filled by the application
+
+/*
+ * Release SDA and wait for the next START.
+ */
+static inline void usi_wait_start(void) {
+    DDR_USI &= ~(1 << PIN_USI_SDA);
+    USICR = USICR_WAIT_START;
+    USISR = USISR_8BIT;
+}
+
+void USI_Slave_Init(uint8_t address) {
+    slave_address = address;
+
+    PORT_USI |= (1 << PIN_USI_SCL) | (1 << PIN_USI_SDA);
+    DDR_USI |= (1 << PIN_USI_SCL);      // SCL output: the USI can hold it low
+    usi_wait_start();
+    USISR = (1 << USISIF) | USISR_8BIT;
+}
+
+/*
+ * Returns the spare buffer, filled with the latest registers so only
+ * the changed ones need to be written. Publish it with
+ * USI_Slave_Commit. Not for use from interrupts.
+ */
+uint8_t *USI_Slave_Begin_Update(void) {
+    uint8_t i, sreg = SREG;
+
+    cli();
+    for (back = 0; back == latest || back == active; back++);  // neither published nor being read
+    SREG = sreg;
+
+    for (i = 0; i < USI_SLAVE_REGS; i++)
+        regs[back][i] = regs[latest][i];
+    return regs[back];
+}
+
+/*
+ * Publishes the buffer of USI_Slave_Begin_Update for the next
+ * transactions (a transaction that is running keeps its buffer).
+ */
+void USI_Slave_Commit(void) {
+    latest = back;
+}
+
+ISR(USI_SLAVE_START_vect) {
+    state = STATE_ADDRESS;
+    DDR_USI &= ~(1 << PIN_USI_SDA);
+
+    // Wait until the START is complete (SCL low) or turned into a STOP (SDA high)
+    while ((PIN_USI & (1 << PIN_USI_SCL)) && !(PIN_USI & (1 << PIN_USI_SDA)));
+
+    if (PIN_USI & (1 << PIN_USI_SDA))
+        USICR = USICR_WAIT_START;       // STOP: wait for the next START
+    else
+        USICR = USICR_TRANSFER;         // receive the address byte
+    USISR = (1 << USISIF) | USISR_8BIT;
+}
+
+ISR(USI_SLAVE_OVF_vect) {
+    switch (state) {
+        case STATE_ADDRESS:
+            if ((USIDR >> 1) != slave_address) {
+                usi_wait_start();
+                return;
+            }
+            if (USIDR & 0x01) {         // master read: snapshot the latest buffer
+                active = latest;
+                state = STATE_SEND_DATA;
+            } else {
+                first_write = 1;
+                state = STATE_REQUEST_DATA;
+            }
+            USIDR = 0;                  // ACK
+            DDR_USI |= (1 << PIN_USI_SDA);
+            USISR = USISR_1BIT;
+            break;
+
+        case STATE_CHECK_ACK:
+            if (USIDR) {                // NACK: master is done
+                usi_wait_start();
+                return;
+            }
+            // fall through: ACK, send the next byte
+        case STATE_SEND_DATA:
+            USIDR = regs[active][pointer];
+            if (++pointer >= USI_SLAVE_REGS)
+                pointer = 0;
+            DDR_USI |= (1 << PIN_USI_SDA);
+            state = STATE_REQUEST_ACK;
+            USISR = USISR_8BIT;
+            break;
+
+        case STATE_REQUEST_ACK:
+            DDR_USI &= ~(1 << PIN_USI_SDA);
+            USIDR = 0;
+            state = STATE_CHECK_ACK;
+            USISR = USISR_1BIT;
+            break;
+
+        case STATE_REQUEST_DATA:
+            DDR_USI &= ~(1 << PIN_USI_SDA);
+            state = STATE_GET_DATA;
+            USISR = USISR_8BIT;
+            break;
+
+        case STATE_GET_DATA:
+            if (first_write) {          // register pointer, later bytes are ignored
+                pointer = USIDR < USI_SLAVE_REGS ? USIDR : 0;
+                first_write = 0;
+            }
+            USIDR = 0;                  // ACK
+            DDR_USI |= (1 << PIN_USI_SDA);
+            state = STATE_REQUEST_DATA;
+            USISR = USISR_1BIT;
+            break;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef __ZST_USI_SLAVE_LIB__
+#define __ZST_USI_SLAVE_LIB__
+
+/* ----------------------------------
+ * USI I2C SLAVE WITH A REGISTER MAP
+ * ----------------------------------
+ *
+ * Interrupt driven, based on AVR312 (Using the USI module as a I2C
+ * slave). The device looks like a small I2C register chip:
+ *
+ *  - Master write: the first byte sets the register pointer, further
+ *    bytes are ACKed and ignored (the registers are read only).
+ *  - Master read: returns registers from the pointer on, the pointer
+ *    increments and wraps at USI_SLAVE_REGS.
+ *
+ * Usual access from the master: write 1 byte (register number),
+ * repeated START, read n bytes.
+ *
+ * The registers are triple buffered. The application fills a spare
+ * buffer (USI_Slave_Begin_Update) and publishes it at once
+ * (USI_Slave_Commit). Each transaction reads from the buffer that was
+ * the latest at its address byte, so the master never sees half an
+ * update, and the application never has to wait for the master.
+ *
+ * The USI holds SCL low after each byte until the overflow interrupt
+ * has run (clock stretching). The interrupt only moves one byte, so
+ * the stretch is about the interrupt latency, ~6us at 8MHz, once per
+ * byte and once per ACK. Masters up to 400KHz work if they support
+ * clock stretching (every I2C master must).
+ *
+ * Uses the USI start and overflow interrupts, needs sei().
+ */
+
+#include <avr/io.h>
+
+#ifndef USI_SLAVE_REGS
+#define USI_SLAVE_REGS  8   // registers in the map
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void USI_Slave_Init(uint8_t address);
+uint8_t *USI_Slave_Begin_Update(void);
+void USI_Slave_Commit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif